@@ -0,0 +1,73 @@
+#pragma once
+
+#include "raylib.h"
+#include "gameboard.h"
+#include "renderer.h"
+#include "engine/threadpool.h"
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Gameboard
+{
+
+    class AssetLoader
+        // Loads assets in two phases. Files are read and decoded into CPU memory on a thread
+        // pool, then Update(), called every frame on the main thread, turns them into textures,
+        // fonts and sounds, which raylib only allows there. The game runs meanwhile: handles of
+        // assets that have not arrived give empty ones and the atlas shows placeholders.
+    {
+    public:
+        // Same as raylib's LoadFont().
+        static constexpr int fontSize = 32;
+        static constexpr int numberOfFontGlyphs = 95;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct DecodedAsset
+        {
+            std::string id;
+            double decodeMilliseconds = 0.0;
+            std::function<void()> finalize;
+            std::function<void()> discard;
+        };
+
+        using Decoder = std::function<DecodedAsset(const std::string& filePath, const std::string& id)>;
+
+        Minesweeper::ThreadPool m_pool;
+
+        // Filled by the workers, drained by Update().
+        std::mutex m_decodedMutex;
+        std::vector<DecodedAsset> m_decoded;
+        std::vector<DecodedAsset> m_finalizing;
+
+        TextureAtlas* m_atlas = nullptr;
+
+        Clock::time_point m_startTime = Clock::now();
+        int m_numberOfQueuedAssets = 0;
+        int m_numberOfLoadedAssets = 0;
+        bool m_hasUpdated = false;
+
+    private:
+        static double GetMillisecondsSince(const Clock::time_point start);
+        void Queue(const char* directoryPath, Decoder decode);
+
+    public:
+        AssetLoader() = default;
+        ~AssetLoader();
+
+        AssetLoader(const AssetLoader&) = delete;
+        AssetLoader& operator=(const AssetLoader&) = delete;
+
+        void QueueTextures(AssetHandler<Texture2D>& textures, TextureAtlas& atlas, const char* directoryPath);
+        void QueueFonts(AssetHandler<Font>& fonts, const char* directoryPath);
+        void QueueSounds(AssetHandler<Sound>& sounds, const char* directoryPath);
+
+        bool Update();
+        void Wait();
+        bool IsDone() const;
+    };
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "engine/board.h"
+#include "engine/generator.h"
+#include "engine/mappedfile.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    // Log of everything a player did to a board. The header holds what is needed to generate
+    // the same board again (dimensions, bombs, seed, generation options) and is followed by one
+    // 8 byte record per action: the time since the game started, in milliseconds, and the tile
+    // index with the action type in its low two bits. Records are appended as the game goes, so
+    // the number of actions is whatever the file length holds.
+
+    enum class ActionType : std::uint8_t
+    {
+        REVEAL,
+        FLAG,
+        UNFLAG,
+        CHORD
+    };
+
+    struct Action
+    {
+        std::uint32_t milliseconds = 0;
+        int index = 0;
+        ActionType type = ActionType::REVEAL;
+    };
+
+    struct ActionLogHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t headerSize;
+        std::int32_t width;
+        std::int32_t height;
+        std::int32_t numberOfBombs;
+        std::uint8_t firstClickPolicy;
+        std::uint8_t isNoGuess;
+        std::uint16_t reserved;
+        std::uint64_t seed;
+        std::int32_t maxAttempts;
+        std::uint32_t reserved2;
+    };
+
+    static_assert(sizeof(ActionLogHeader) == 48, "The action log header is part of the file format");
+
+    class ActionLog
+    {
+    public:
+        static constexpr char magic[8] = { 'M', 'S', 'W', 'P', 'L', 'O', 'G', '\0' };
+        static constexpr std::uint32_t version = 1;
+        static constexpr size_t recordSize = 8;
+
+        // Indices must leave the low two bits of a record free for the type.
+        static constexpr int maxNumberOfTiles = 1 << 30;
+
+    public:
+        static ActionLogHeader CreateHeader(const IntVector2 dimensions, const int numberOfBombs, const GenerationOptions& options, const std::uint64_t seed);
+        static GenerationOptions GetGenerationOptions(const ActionLogHeader& header);
+
+        static void Encode(const Action& action, std::byte* destination);
+        static Action Decode(const std::byte* source);
+    };
+
+    class ActionLogWriter
+        // Streams actions to a file through a fixed size buffer: memory use does not grow with
+        // the game, and the disk sees one write per bufferCapacity actions.
+    {
+    private:
+        std::FILE* m_file = nullptr;
+        std::string m_filePath;
+        std::vector<std::byte> m_buffer;
+        size_t m_bufferCapacity;
+
+    public:
+        ActionLogWriter(const std::string& filePath, const ActionLogHeader& header, const size_t bufferCapacity = 4096);
+        ~ActionLogWriter();
+
+        ActionLogWriter(const ActionLogWriter&) = delete;
+        ActionLogWriter& operator=(const ActionLogWriter&) = delete;
+
+        void Append(const Action& action);
+        void Flush();
+    };
+
+    class ActionLogReader
+        // A whole log mapped read-only; actions are decoded on demand.
+    {
+    private:
+        MappedFile m_file;
+        ActionLogHeader m_header;
+        const std::byte* m_records = nullptr;
+        size_t m_numberOfActions = 0;
+
+    public:
+        explicit ActionLogReader(const std::string& filePath);
+
+        const ActionLogHeader& GetHeader() const;
+        size_t GetNumberOfActions() const;
+        Action GetAction(const size_t actionIndex) const;
+    };
+
+    struct ReplayResult
+    {
+        size_t numberOfActions = 0;
+        std::int64_t firstMismatch = -1;    // First action whose outcome differs from the recorded one.
+        bool isBombTriggered = false;
+        bool isCleared = false;
+    };
+
+    bool ApplyAction(Board& board, const Action& action, const GenerationOptions& options, const std::uint64_t seed);
+    ReplayResult Replay(const ActionLogReader& log, Board& board);
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "engine/bitplane.h"
+#include "engine/intvector2.h"
+#include <cstdint>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    enum class SimdLevel
+    {
+        SCALAR,     // 64 tiles per step, in general purpose registers.
+        AVX2        // 256 tiles per step.
+    };
+
+    class AdjacencyCounter
+        // Counts the bombs around every tile a row at a time with bit-sliced adders: the eight
+        // shifted neighbour rows are summed bitwise into four planes holding the bits of the
+        // counts, then spread into one byte per tile. The row buffers are kept between calls,
+        // so once warmed up counting does no heap allocation.
+    {
+    private:
+        std::vector<std::uint64_t> m_rows;
+
+    public:
+        static SimdLevel GetSupportedSimdLevel();
+
+        void Count(const BitPlane& bombs, const IntVector2 dimensions, std::uint8_t* counts, BitPlane& emptyTiles, SimdLevel level = GetSupportedSimdLevel());
+        void CountRows(const BitPlane& bombs, const IntVector2 dimensions, const int startY, const int endY, std::uint8_t* counts, BitPlane& emptyTiles,
+            SimdLevel level = GetSupportedSimdLevel());
+    };
+};
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    // One bit per tile, stored row-major in 64-bit words.
+    class BitPlane
+    {
+    private:
+        std::vector<std::uint64_t> m_words;
+        size_t m_size = 0;
+
+    public:
+        BitPlane() = default;
+        BitPlane(const size_t size, const bool value = false)
+        {
+            Assign(size, value);
+        }
+
+        void Assign(const size_t size, const bool value)
+        {
+            m_size = size;
+            m_words.assign((size + 63) / 64, value ? ~std::uint64_t(0) : 0);
+            ClearPadding();
+        }
+
+        void Fill(const bool value)
+        {
+            Assign(m_size, value);
+        }
+
+        size_t Size() const
+        {
+            return m_size;
+        }
+
+        bool Get(const size_t index) const
+        {
+            return (m_words[index >> 6] >> (index & 63)) & 1;
+        }
+
+        void Set(const size_t index)
+        {
+            m_words[index >> 6] |= std::uint64_t(1) << (index & 63);
+        }
+
+        void Reset(const size_t index)
+        {
+            m_words[index >> 6] &= ~(std::uint64_t(1) << (index & 63));
+        }
+
+        void Set(const size_t index, const bool value)
+        {
+            if (value) Set(index);
+            else Reset(index);
+        }
+
+        void Flip(const size_t index)
+        {
+            m_words[index >> 6] ^= std::uint64_t(1) << (index & 63);
+        }
+
+        std::uint64_t GetBits(const size_t index) const
+            // The 64 bits starting at index, bit 0 being index. Bits past the end read as zero.
+        {
+            const size_t word = index >> 6;
+            const unsigned shift = index & 63;
+
+            std::uint64_t bits = m_words[word] >> shift;
+            if (shift != 0 && word + 1 < m_words.size()) bits |= m_words[word + 1] << (64 - shift);
+
+            return bits;
+        }
+
+        void StoreBits(const size_t index, const std::uint64_t bits, const unsigned count)
+            // Overwrites the count (1 to 64) bits starting at index with the low bits of bits.
+        {
+            const std::uint64_t mask = count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+            const size_t word = index >> 6;
+            const unsigned shift = index & 63;
+
+            m_words[word] = (m_words[word] & ~(mask << shift)) | ((bits & mask) << shift);
+
+            if (shift != 0 && shift + count > 64) {
+                m_words[word + 1] = (m_words[word + 1] & ~(mask >> (64 - shift))) | ((bits & mask) >> (64 - shift));
+            }
+        }
+
+        void ResetBits(const size_t index, const std::uint64_t bits)
+            // Clears bit index + i for every set bit i of bits. Bits past the end must be clear.
+        {
+            const size_t word = index >> 6;
+            const unsigned shift = index & 63;
+
+            m_words[word] &= ~(bits << shift);
+            if (shift != 0 && word + 1 < m_words.size()) m_words[word + 1] &= ~(bits >> (64 - shift));
+        }
+
+        void SetRange(const size_t begin, const size_t end)
+            // Sets bits [begin, end).
+        {
+            if (begin >= end) return;
+
+            const size_t firstWord = begin >> 6;
+            const size_t lastWord = (end - 1) >> 6;
+            const std::uint64_t firstMask = ~std::uint64_t(0) << (begin & 63);
+            const std::uint64_t lastMask = ~std::uint64_t(0) >> (63 - ((end - 1) & 63));
+
+            if (firstWord == lastWord)
+            {
+                m_words[firstWord] |= firstMask & lastMask;
+                return;
+            }
+
+            m_words[firstWord] |= firstMask;
+            for (size_t w = firstWord + 1; w < lastWord; w++) m_words[w] = ~std::uint64_t(0);
+            m_words[lastWord] |= lastMask;
+        }
+
+        void ResetRange(const size_t begin, const size_t end)
+            // Clears bits [begin, end).
+        {
+            if (begin >= end) return;
+
+            const size_t firstWord = begin >> 6;
+            const size_t lastWord = (end - 1) >> 6;
+            const std::uint64_t firstMask = ~std::uint64_t(0) << (begin & 63);
+            const std::uint64_t lastMask = ~std::uint64_t(0) >> (63 - ((end - 1) & 63));
+
+            if (firstWord == lastWord)
+            {
+                m_words[firstWord] &= ~(firstMask & lastMask);
+                return;
+            }
+
+            m_words[firstWord] &= ~firstMask;
+            for (size_t w = firstWord + 1; w < lastWord; w++) m_words[w] = 0;
+            m_words[lastWord] &= ~lastMask;
+        }
+
+        size_t Count() const
+        {
+            size_t count = 0;
+            for (const std::uint64_t word : m_words)
+            {
+                count += (size_t)std::popcount(word);
+            }
+            return count;
+        }
+
+        template <typename T_Callback>
+        void ForEachSetBit(const size_t begin, const size_t end, T_Callback&& callback) const
+            // Calls callback(index) for every set bit in [begin, end) in ascending order.
+        {
+            if (begin >= end) return;
+
+            const size_t firstWord = begin >> 6;
+            const size_t lastWord = (end - 1) >> 6;
+
+            for (size_t w = firstWord; w <= lastWord; w++)
+            {
+                std::uint64_t word = m_words[w];
+                if (w == firstWord) word &= ~std::uint64_t(0) << (begin & 63);
+                if (w == lastWord) word &= ~std::uint64_t(0) >> (63 - ((end - 1) & 63));
+
+                while (word)
+                {
+                    callback(w * 64 + (size_t)std::countr_zero(word));
+                    word &= word - 1;
+                }
+            }
+        }
+
+        template <typename T_Callback>
+        void ForEachSetBit(T_Callback&& callback) const
+        {
+            ForEachSetBit(0, m_size, callback);
+        }
+
+        std::uint64_t* Data()
+        {
+            return m_words.data();
+        }
+
+        const std::uint64_t* Data() const
+        {
+            return m_words.data();
+        }
+
+        size_t WordCount() const
+        {
+            return m_words.size();
+        }
+
+    private:
+        void ClearPadding()
+            // Bits past m_size must stay zero so Count() and ForEachSetBit() stay exact.
+        {
+            if (m_size % 64 != 0) m_words.back() &= (std::uint64_t(1) << (m_size % 64)) - 1;
+        }
+    };
+
+    class BitPlaneView
+        // Bits [begin, begin + size) of a BitPlane as a plane of their own, so PlaceBombs can
+        // fill one band of a board. Views that begin and end on word boundaries share no words,
+        // so they can be written from different threads.
+    {
+    private:
+        BitPlane& m_plane;
+        size_t m_begin;
+        size_t m_size;
+
+    public:
+        BitPlaneView(BitPlane& plane, const size_t begin, const size_t size)
+            : m_plane(plane),
+            m_begin(begin),
+            m_size(size)
+        {
+        }
+
+        void Fill(const bool value)
+        {
+            if (value) m_plane.SetRange(m_begin, m_begin + m_size);
+            else m_plane.ResetRange(m_begin, m_begin + m_size);
+        }
+
+        size_t Size() const
+        {
+            return m_size;
+        }
+
+        bool Get(const size_t index) const
+        {
+            return m_plane.Get(m_begin + index);
+        }
+
+        void Set(const size_t index)
+        {
+            m_plane.Set(m_begin + index);
+        }
+
+        void Reset(const size_t index)
+        {
+            m_plane.Reset(m_begin + index);
+        }
+
+        void Set(const size_t index, const bool value)
+        {
+            m_plane.Set(m_begin + index, value);
+        }
+    };
+
+    template <size_t T_Size>
+    class FixedBitPlane
+        // BitPlane of a size known at compile time, stored inline. Has the subset of the
+        // BitPlane interface PlaceBombs() uses, so placement is the same on both.
+    {
+    private:
+        static constexpr size_t wordCount = (T_Size + 63) / 64;
+
+        std::array<std::uint64_t, wordCount> m_words = {};
+
+    public:
+        void Fill(const bool value)
+        {
+            m_words.fill(value ? ~std::uint64_t(0) : 0);
+            if constexpr (T_Size % 64 != 0) m_words.back() &= (std::uint64_t(1) << (T_Size % 64)) - 1;
+        }
+
+        static constexpr size_t Size()
+        {
+            return T_Size;
+        }
+
+        bool Get(const size_t index) const
+        {
+            return (m_words[index >> 6] >> (index & 63)) & 1;
+        }
+
+        void Set(const size_t index)
+        {
+            m_words[index >> 6] |= std::uint64_t(1) << (index & 63);
+        }
+
+        void Reset(const size_t index)
+        {
+            m_words[index >> 6] &= ~(std::uint64_t(1) << (index & 63));
+        }
+
+        void Set(const size_t index, const bool value)
+        {
+            if (value) Set(index);
+            else Reset(index);
+        }
+
+        template <typename T_Callback>
+        void ForEachSetBit(T_Callback&& callback) const
+            // Calls callback(index) for every set bit in ascending order.
+        {
+            for (size_t w = 0; w < wordCount; w++)
+            {
+                std::uint64_t word = m_words[w];
+
+                while (word)
+                {
+                    callback(w * 64 + (size_t)std::countr_zero(word));
+                    word &= word - 1;
+                }
+            }
+        }
+    };
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "engine/adjacency.h"
+#include "engine/bitplane.h"
+#include "engine/floodfill.h"
+#include "engine/intvector2.h"
+#include "engine/placement.h"
+#include "engine/random.h"
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    enum class ContentOption : int
+    {
+        BOMB = -1,
+        EMPTY = 0,
+        ONE = 1,
+        TWO = 2,
+        THREE = 3,
+        FOUR = 4,
+        FIVE = 5,
+        SIX = 6,
+        SEVEN = 7,
+        EIGHT = 8
+    };
+
+    // Pure board state and game rules. Has no dependency on raylib so it can be
+    // driven headless (simulations, tools) as well as by MinesweeperGrid.
+    class Board
+    {
+    public:
+        enum class RevealResult
+        {
+            NOTHING,
+            REVEALED,
+            EXPLODED
+        };
+
+        enum class FlagResult
+        {
+            NOTHING,
+            FLAG_ADDED,
+            FLAG_REMOVED
+        };
+
+        // Rows per band in GenerateInBands(). A multiple of 64, so every band starts on a word
+        // boundary of the bit planes.
+        static constexpr int generationBandHeight = 64;
+
+    private:
+        friend class FloodFill;
+        friend class Snapshot;
+
+        // Struct-of-arrays storage, one row-major buffer per attribute.
+        IntVector2 m_dimensions;
+        std::vector<std::uint8_t> m_adjacentBombs;
+        BitPlane m_bombs;
+        BitPlane m_covered;
+        BitPlane m_flagged;
+        BitPlane m_emptyTiles;  // No bomb and no bomb around, kept with m_adjacentBombs.
+
+        int m_numberOfBombs;
+        int m_numberOfBombsLeft;
+        int m_numberOfFlagsLeft;
+        int m_numberOfCoveredSafeTiles;
+
+        bool m_isGenerated = false;
+        bool m_isBombTriggered = false;
+
+        FloodFill m_floodFill;
+        std::vector<TileSpan> m_revealedTiles;
+        AdjacencyCounter m_adjacencyCounter;
+
+    private:
+        void ResetState();
+        void ResetCounters();
+        void CountAdjacentBombs();
+        void Uncover(const int index);
+        RevealResult RevealTile(const int index);
+
+    public:
+        Board(const IntVector2 dimensions, const int numberOfBombs);
+        Board(const IntVector2 dimensions, const int numberOfBombs, const std::uint64_t seed);
+
+        template <typename T_Random>
+            requires std::uniform_random_bit_generator<std::remove_cvref_t<T_Random>>
+        Board(const IntVector2 dimensions, const int numberOfBombs, T_Random&& random)
+            : Board(dimensions, numberOfBombs)
+        {
+            Generate(random);
+        }
+
+        void Reset(const IntVector2 dimensions, const int numberOfBombs);
+
+        template <typename T_Random>
+        void Generate(T_Random&& random, const std::vector<int>& safeTiles = {})
+            // Places the bombs and starts a new game on this board. safeTiles (sorted
+            // ascending) are guaranteed not to hold a bomb.
+        {
+            if ((size_t)m_numberOfBombs + safeTiles.size() > m_bombs.Size()) {
+                throw std::invalid_argument("Too many safe tiles for the number of bombs");
+            }
+
+            ResetState();
+            PlaceBombs(m_bombs, m_numberOfBombs, random, safeTiles);
+            CountAdjacentBombs();
+            m_isGenerated = true;
+        }
+
+        void GenerateInBands(const std::uint64_t seed, const std::vector<int>& safeTiles = {}, const int numberOfThreads = 0);
+
+        bool IsGenerated() const;
+
+        IntVector2 GetDimensions() const;
+        int GetNumberOfTiles() const;
+        bool IsInsideBoard(const IntVector2 coords) const;
+        int GetIndex(const IntVector2 coords) const;
+        IntVector2 GetCoords(const int index) const;
+
+        ContentOption GetContentOption(const int index) const;
+        bool IsBomb(const int index) const;
+        bool IsTileCovered(const int index) const;
+        bool IsTileFlagged(const int index) const;
+
+        ContentOption GetContentOption(const IntVector2 coords) const;
+        bool IsBomb(const IntVector2 coords) const;
+        bool IsTileCovered(const IntVector2 coords) const;
+        bool IsTileFlagged(const IntVector2 coords) const;
+
+        RevealResult Reveal(const int index);
+        RevealResult Reveal(const IntVector2 coords);
+        FlagResult ToggleFlag(const IntVector2 coords);
+        RevealResult Chord(const IntVector2 coords);
+        void RevealBombs();
+        const std::vector<TileSpan>& GetRevealedTiles() const;
+
+        bool IsBombTriggered() const;
+        bool IsCleared() const;
+        int GetNumberOfBombs() const;
+        int GetNumberOfFlagsLeft() const;
+        int GetNumberOfBombsLeft() const;
+    };
+};
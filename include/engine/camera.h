@@ -0,0 +1,42 @@
+#pragma once
+
+namespace Gameboard
+{
+
+    struct FloatVector2
+    {
+        float x, y;
+    };
+
+    class GridCamera
+        // Pan and zoom over world (grid layout) positions. Uses raylib's Camera2D convention,
+        // screen = (world - target) * zoom + offset, so it converts directly to one.
+    {
+    private:
+        FloatVector2 m_offset = { 0.0f, 0.0f };
+        FloatVector2 m_target = { 0.0f, 0.0f };
+        float m_zoom = 1.0f;
+        float m_minZoom = 0.05f;
+        float m_maxZoom = 8.0f;
+
+    public:
+        FloatVector2 GetOffset() const;
+        void SetOffset(const FloatVector2 offset);
+
+        FloatVector2 GetTarget() const;
+        void SetTarget(const FloatVector2 target);
+
+        float GetZoom() const;
+        void SetZoom(const float zoom);
+        float GetMinZoom() const;
+        float GetMaxZoom() const;
+        void SetZoomLimits(const float minZoom, const float maxZoom);
+
+        void Pan(const FloatVector2 screenDelta);
+        void ZoomAt(const FloatVector2 screenPosition, const float factor);
+        void Reset();
+
+        FloatVector2 ScreenToWorld(const FloatVector2 screenPosition) const;
+        FloatVector2 WorldToScreen(const FloatVector2 worldPosition) const;
+    };
+};
@@ -0,0 +1,281 @@
+#pragma once
+
+#include "engine/bitplane.h"
+#include "engine/board.h"
+#include "engine/intvector2.h"
+#include "engine/placement.h"
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    template <int T_Width, int T_Height>
+    class FixedBoard
+        // Board of a size known at compile time, for the classic presets. Same rules and same
+        // bomb placement for a given random sequence as Board, but every buffer is inline and
+        // padded with a one tile border, so neighbour offsets are constants, no neighbour needs
+        // a bounds check and the compiler unrolls the counting and flood loops. Board remains
+        // the type for any other size and for everything that needs revealed spans (renderer,
+        // Solver, snapshots).
+    {
+        static_assert(T_Width > 0 && T_Height > 0, "Board dimensions must be positive");
+
+    public:
+        using RevealResult = Board::RevealResult;
+        using FlagResult = Board::FlagResult;
+
+        static constexpr int numberOfTiles = T_Width * T_Height;
+        static constexpr int paddedWidth = T_Width + 2;
+        static constexpr int paddedSize = paddedWidth * (T_Height + 2);
+        static constexpr std::array<int, 8> neighbourOffsets = {
+            -paddedWidth - 1, -paddedWidth, -paddedWidth + 1, -1, 1, paddedWidth - 1, paddedWidth, paddedWidth + 1
+        };
+
+    private:
+        // Tile states, indexed by padded index. The border is none of these, so it is never
+        // uncovered or counted as open.
+        static constexpr std::uint8_t COVERED = 1;
+        static constexpr std::uint8_t FLAGGED = 2;
+        static constexpr std::uint8_t BOMB = 4;
+
+        static constexpr std::array<std::uint8_t, paddedSize> coveredStates = [] {
+            std::array<std::uint8_t, paddedSize> states = {};
+            for (int y = 1; y <= T_Height; y++)
+            {
+                for (int x = 1; x <= T_Width; x++) states[y * paddedWidth + x] = COVERED;
+            }
+            return states;
+        }();
+
+        std::array<std::uint8_t, paddedSize> m_states;
+        std::array<std::uint8_t, paddedSize> m_adjacentBombs;
+        FixedBitPlane<numberOfTiles> m_bombs;  // Flat indices, as PlaceBombs() fills it.
+        std::array<int, numberOfTiles> m_floodStack;
+
+        int m_numberOfBombs;
+        int m_numberOfBombsLeft;
+        int m_numberOfFlagsLeft;
+        int m_numberOfCoveredSafeTiles;
+
+        bool m_isGenerated = false;
+        bool m_isBombTriggered = false;
+
+    private:
+        static constexpr int GetPaddedIndex(const int index)
+        {
+            return index + paddedWidth + 1 + 2 * (index / T_Width);
+        }
+
+        void Uncover(const int paddedIndex)
+        {
+            m_states[paddedIndex] &= ~COVERED;
+            if (!(m_states[paddedIndex] & BOMB)) m_numberOfCoveredSafeTiles--;
+        }
+
+        void Flood(const int paddedIndex)
+            // Uncovers the empty tile at paddedIndex and everything it opens. Tiles are uncovered
+            // before they are pushed, so each is pushed at most once and the stack cannot overflow.
+        {
+            int numberOfSeeds = 0;
+
+            Uncover(paddedIndex);
+            m_floodStack[numberOfSeeds++] = paddedIndex;
+
+            while (numberOfSeeds > 0)
+            {
+                const int seed = m_floodStack[--numberOfSeeds];
+
+                for (const int offset : neighbourOffsets)
+                {
+                    const int neighbour = seed + offset;
+
+                    // Neighbours of an empty tile are never bombs.
+                    if (m_states[neighbour] != COVERED) continue;
+
+                    Uncover(neighbour);
+                    if (m_adjacentBombs[neighbour] == 0) m_floodStack[numberOfSeeds++] = neighbour;
+                }
+            }
+        }
+
+    public:
+        explicit FixedBoard(const int numberOfBombs)
+        {
+            Reset(numberOfBombs);
+        }
+
+        void Reset(const int numberOfBombs)
+            // Starts over with an ungenerated board.
+        {
+            if (numberOfBombs < 0 || numberOfBombs > numberOfTiles) {
+                throw std::invalid_argument("Number of bombs must fit on the board");
+            }
+
+            m_states = coveredStates;
+            m_adjacentBombs.fill(0);
+            m_bombs.Fill(false);
+
+            m_numberOfBombs = numberOfBombs;
+            m_numberOfBombsLeft = numberOfBombs;
+            m_numberOfFlagsLeft = numberOfBombs;
+            m_numberOfCoveredSafeTiles = numberOfTiles - numberOfBombs;
+
+            m_isGenerated = false;
+            m_isBombTriggered = false;
+        }
+
+        template <typename T_Random>
+        void Generate(T_Random&& random, const std::vector<int>& safeTiles = {})
+            // Places the bombs and starts a new game on this board. safeTiles (sorted
+            // ascending) are guaranteed not to hold a bomb.
+        {
+            if ((size_t)m_numberOfBombs + safeTiles.size() > (size_t)numberOfTiles) {
+                throw std::invalid_argument("Too many safe tiles for the number of bombs");
+            }
+
+            Reset(m_numberOfBombs);
+            PlaceBombs(m_bombs, m_numberOfBombs, random, safeTiles);
+
+            m_bombs.ForEachSetBit([this](const size_t index) {
+                const int paddedIndex = GetPaddedIndex((int)index);
+                m_states[paddedIndex] |= BOMB;
+
+                for (const int offset : neighbourOffsets) m_adjacentBombs[paddedIndex + offset]++;
+            });
+
+            m_isGenerated = true;
+        }
+
+        bool IsGenerated() const
+        {
+            return m_isGenerated;
+        }
+
+        static constexpr IntVector2 GetDimensions()
+        {
+            return IntVector2{ T_Width, T_Height };
+        }
+
+        static constexpr int GetNumberOfTiles()
+        {
+            return numberOfTiles;
+        }
+
+        static constexpr bool IsInsideBoard(const IntVector2 coords)
+        {
+            return coords.x >= 0 && coords.x < T_Width && coords.y >= 0 && coords.y < T_Height;
+        }
+
+        static constexpr int GetIndex(const IntVector2 coords)
+        {
+            if (!IsInsideBoard(coords)) {
+                throw std::out_of_range("Coordinates are outside the board");
+            }
+
+            return coords.y * T_Width + coords.x;
+        }
+
+        static constexpr IntVector2 GetCoords(const int index)
+        {
+            return IntVector2{ index % T_Width, index / T_Width };
+        }
+
+        ContentOption GetContentOption(const int index) const
+        {
+            const int paddedIndex = GetPaddedIndex(index);
+            if (m_states[paddedIndex] & BOMB) return ContentOption::BOMB;
+
+            return static_cast<ContentOption>(m_adjacentBombs[paddedIndex]);
+        }
+
+        bool IsBomb(const int index) const
+        {
+            return m_states[GetPaddedIndex(index)] & BOMB;
+        }
+
+        bool IsTileCovered(const int index) const
+        {
+            return m_states[GetPaddedIndex(index)] & COVERED;
+        }
+
+        bool IsTileFlagged(const int index) const
+        {
+            return m_states[GetPaddedIndex(index)] & FLAGGED;
+        }
+
+        RevealResult Reveal(const int index)
+        {
+            const int paddedIndex = GetPaddedIndex(index);
+            const std::uint8_t state = m_states[paddedIndex];
+
+            if (!(state & COVERED) || (state & FLAGGED)) return RevealResult::NOTHING;
+
+            if (state & BOMB)
+            {
+                Uncover(paddedIndex);
+                m_isBombTriggered = true;
+                return RevealResult::EXPLODED;
+            }
+
+            if (m_adjacentBombs[paddedIndex] == 0) Flood(paddedIndex);
+            else Uncover(paddedIndex);
+
+            return RevealResult::REVEALED;
+        }
+
+        RevealResult Reveal(const IntVector2 coords)
+        {
+            return Reveal(GetIndex(coords));
+        }
+
+        FlagResult ToggleFlag(const IntVector2 coords)
+        {
+            std::uint8_t& state = m_states[GetPaddedIndex(GetIndex(coords))];
+            if (!(state & COVERED)) return FlagResult::NOTHING;
+
+            if (state & FLAGGED)
+            {
+                if (state & BOMB) m_numberOfBombsLeft += 1;
+                m_numberOfFlagsLeft += 1;
+                state &= ~FLAGGED;
+
+                return FlagResult::FLAG_REMOVED;
+            }
+
+            if (m_numberOfFlagsLeft <= 0) return FlagResult::NOTHING;
+            if (state & BOMB) m_numberOfBombsLeft -= 1;
+            m_numberOfFlagsLeft -= 1;
+            state |= FLAGGED;
+
+            return FlagResult::FLAG_ADDED;
+        }
+
+        bool IsBombTriggered() const
+        {
+            return m_isBombTriggered;
+        }
+
+        bool IsCleared() const
+        {
+            return m_numberOfCoveredSafeTiles == 0;
+        }
+
+        int GetNumberOfBombs() const
+        {
+            return m_numberOfBombs;
+        }
+
+        int GetNumberOfFlagsLeft() const
+        {
+            return m_numberOfFlagsLeft;
+        }
+
+        int GetNumberOfBombsLeft() const
+        {
+            return m_numberOfBombsLeft;
+        }
+    };
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    class Board;
+
+    struct TileSpan
+        // Horizontal run of tiles [startX, endX] on row y.
+    {
+        int y;
+        int startX;
+        int endX;
+    };
+
+    class FloodFill
+        // Iterative scanline reveal of an empty region. The seed stack is kept between
+        // calls so that, once warmed up, a reveal does no heap allocation.
+    {
+    private:
+        std::vector<int> m_seeds;
+
+    private:
+        std::uint64_t GetOpenBits(const Board& board, const int index) const;
+        std::uint64_t GetFloodableBits(const Board& board, const int index) const;
+        bool IsFloodable(const Board& board, const int index) const;
+        int UncoverRun(Board& board, const int y, const int startX, const int endX, std::vector<TileSpan>& revealedTiles);
+        int UncoverNeighbourRow(Board& board, const int y, const int startX, const int endX, std::vector<TileSpan>& revealedTiles);
+
+    public:
+        int Reveal(Board& board, const int startIndex, std::vector<TileSpan>& revealedTiles);
+        int Reveal(Board& board, const std::span<const int> startIndices, std::vector<TileSpan>& revealedTiles);
+    };
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "engine/board.h"
+#include "engine/neighbours.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    enum class FirstClickPolicy
+    {
+        UNSAFE,     // The first click may hit a bomb.
+        SAFE,       // The first clicked tile is never a bomb.
+        OPENING     // The first clicked tile is empty, so it always opens an area.
+    };
+
+    struct GenerationOptions
+    {
+        FirstClickPolicy firstClickPolicy = FirstClickPolicy::SAFE;
+        bool isNoGuess = false;     // Regenerate until the Solver clears the board from the first click.
+        int numberOfThreads = 0;    // 0 uses every hardware thread.
+        int maxAttempts = 100000;
+    };
+
+    // Boards with at least this many tiles are generated in bands over every thread (see
+    // Board::GenerateInBands), smaller ones from a single random stream.
+    constexpr int bandedGenerationMinTiles = 1 << 24;
+
+    template <typename T_Board>
+    std::vector<int> GetFirstClickSafeTiles(const T_Board& board, const IntVector2 firstClick, FirstClickPolicy policy)
+        // Tiles the first click's policy keeps free of bombs, sorted ascending. Falls back to
+        // a weaker policy when the board is too full to honour it.
+    {
+        const int numberOfFreeTiles = board.GetNumberOfTiles() - board.GetNumberOfBombs();
+        const int firstClickIndex = board.GetIndex(firstClick);
+        std::vector<int> safeTiles;
+
+        if (policy == FirstClickPolicy::OPENING)
+        {
+            safeTiles.push_back(firstClickIndex);
+            ForEachNeighbourIndex(firstClickIndex, board.GetDimensions(), [&](const int neighbour) {
+                safeTiles.push_back(neighbour);
+            });
+
+            if ((int)safeTiles.size() <= numberOfFreeTiles)
+            {
+                std::sort(safeTiles.begin(), safeTiles.end());
+                return safeTiles;
+            }
+
+            safeTiles.clear();
+            policy = FirstClickPolicy::SAFE;
+        }
+
+        if (policy == FirstClickPolicy::SAFE && numberOfFreeTiles >= 1) safeTiles.push_back(firstClickIndex);
+
+        return safeTiles;
+    }
+
+    bool GenerateBoard(Board& board, const IntVector2 firstClick, const GenerationOptions& options, const std::uint64_t seed);
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "engine/camera.h"
+#include "engine/intvector2.h"
+#include "engine/neighbours.h"
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace Gameboard
+{
+
+    // Screen layout of grids of drawables. Kept free of raylib so positioning and
+    // hit-testing run headless (benchmarks, tools).
+
+    enum AnchorPoints
+    {
+        TOP_LEFT,
+        TOP_MIDDLE,
+        TOP_RIGHT,
+
+        MIDDLE_LEFT,
+        MIDDLE,
+        MIDDLE_RIGHT,
+
+        BOTTOM_LEFT,
+        BOTTOM_MIDDLE,
+        BOTTOM_RIGHT,
+    };
+
+    class Drawable
+    {
+    protected:
+        IntVector2 m_margin = { 0,0 };
+        IntVector2 m_dimensions = { 0,0 };
+        IntVector2 m_positionOnScreen = { 0,0 };
+        IntVector2 m_coords = { 0,0 };
+
+    public:
+        Drawable(const IntVector2 dimensions, const IntVector2 margin);
+
+        virtual void Render() const = 0;
+
+        virtual int GetWidth() const;
+        virtual void SetWidth(const int width);
+
+        virtual int GetHeight() const;
+        virtual void SetHeight(const int height);
+
+        virtual int GetMarginWidth() const;
+        virtual void SetMarginWidth(const int marginWidth);
+
+        virtual int GetMarginHeight() const;
+        virtual void SetMarginHeight(const int marginHeight);
+
+        virtual void SetPositionOnScreen(const int x, const int y);
+        virtual IntVector2 GetPositionOnScreen() const;
+
+        virtual void SetGridCoords(const IntVector2 coords);
+        virtual IntVector2 GetGridCoords() const;
+    };
+
+    class GridLayout
+        // Regular grid of equally sized cells. Cell positions are computed from the
+        // grid origin and pitch (cell size + margin) rather than stored per cell.
+    {
+    protected:
+        AnchorPoints m_anchorPoint = AnchorPoints::TOP_LEFT;
+        IntVector2 m_dimensions = { 0,0 };
+        IntVector2 m_cellDimensions = { 0,0 };
+        IntVector2 m_cellMargin = { 0,0 };
+        IntVector2 m_origin = { 0,0 };
+
+    protected:
+        IntVector2 GetBoardPixelDimensions() const;
+        IntVector2 GetAnchorOffset() const;
+
+    public:
+        GridLayout(const IntVector2 dimensions, const Drawable& sampleEntity, const AnchorPoints anchorPoint);
+
+        IntVector2 GetDimensions() const;
+        IntVector2 GetPitch() const;
+
+        void SetAnchorPoint(const AnchorPoints anchorPoint);
+        void SetPositionsOnScreen(const IntVector2 position);
+        void Resize(const IntVector2 dimensions, const Drawable& sampleEntity);
+        IntVector2 GetCellPositionOnScreen(const IntVector2 coords) const;
+        bool GetCellAt(const float x, const float y, IntVector2& coords) const;
+        bool GetCellAt(const GridCamera& camera, const FloatVector2 screenPosition, IntVector2& coords) const;
+        bool GetVisibleCells(const GridCamera& camera, const IntVector2 screenDimensions, IntVector2& first, IntVector2& last) const;
+
+        virtual void ProcessMouseInput();
+    };
+
+    template <typename T_Entity = Drawable>
+    class Grid : public GridLayout
+    {
+    protected:
+        typedef std::vector<std::vector<T_Entity>> T_Grid;
+        T_Grid m_grid;
+
+    protected:
+        T_Grid GenerateBoard(const IntVector2 dimensions, T_Entity sampleSquare)
+        {
+            static_assert(std::is_base_of<Drawable, T_Entity>::value, "T_Entity must derive from Gameboard::Drawable");
+
+            if (dimensions.x <= 0 || dimensions.y <= 0) {
+                throw std::invalid_argument("Board dimensions must be positive");
+            }
+
+            T_Grid board;
+            board.reserve(dimensions.y);
+
+            // Populate board with tiles, building each row in place.
+            for (int y = 0; y < dimensions.y; y++)
+            {
+                std::vector<T_Entity>& row = board.emplace_back();
+                row.reserve(dimensions.x);
+
+                for (int x = 0; x < dimensions.x; x++)
+                {
+                    sampleSquare.SetGridCoords(IntVector2{ x, y });
+                    row.push_back(sampleSquare);
+                }
+            }
+
+            return board;
+        }
+        
+        virtual bool ShouldRenderEntity(const IntVector2 coords) const
+        {
+            return true;
+        }
+    
+    public:
+        Grid(const IntVector2 dimensions, const T_Entity sampleEntity, const AnchorPoints anchorPoint, const IntVector2 position)
+            : GridLayout(dimensions, sampleEntity, anchorPoint)
+        {
+            m_grid = GenerateBoard(dimensions, sampleEntity);
+            SetPositionsOnScreen(position);
+        }
+        
+        void SetPositionsOnScreen(const IntVector2 position)
+            // Function adds position of each square on the screen to it's attributes so other methods can access it.
+        {
+            GridLayout::SetPositionsOnScreen(position);
+
+            for (int y = 0; y < m_grid.size(); y++)
+            {
+                for (int x = 0; x < m_grid[y].size(); x++)
+                {
+                    const IntVector2 positionOnScreen = GetCellPositionOnScreen(IntVector2{ x, y });
+                    m_grid[y][x].SetPositionOnScreen(positionOnScreen.x, positionOnScreen.y);
+                }
+            }
+        }
+
+        void DisplayGrid() const
+        {
+
+            for (int y = 0; y < m_grid.size(); y++)
+            {
+                for (int x = 0; x < m_grid[y].size(); x++)
+                {
+                    if (ShouldRenderEntity(IntVector2{ x, y }))
+                    {
+                        m_grid[y][x].Render();
+                    }
+                }
+            }
+        }
+
+        template <typename T_Callback>
+        void ForEachNeighbour(const IntVector2 coords, T_Callback&& callback)
+            // Calls callback(T_Entity&) for each neighbour of coords without copying or allocating.
+        {
+            Minesweeper::ForEachNeighbour(coords, m_dimensions, [&](const IntVector2 neighbour) {
+                callback(m_grid[neighbour.y][neighbour.x]);
+            });
+        }
+
+        template <typename T_Callback>
+        void ForEachNeighbour(const IntVector2 coords, T_Callback&& callback) const
+        {
+            Minesweeper::ForEachNeighbour(coords, m_dimensions, [&](const IntVector2 neighbour) {
+                callback(m_grid[neighbour.y][neighbour.x]);
+            });
+        }
+
+        std::vector<T_Entity> GetNeighbours(const T_Entity& tile) const
+        {
+            std::vector<T_Entity> neighbours;
+
+            ForEachNeighbour(tile.GetGridCoords(), [&](const T_Entity& neighbour) {
+                neighbours.push_back(neighbour);
+            });
+
+            return neighbours;
+        }
+    };
+};
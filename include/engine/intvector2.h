@@ -0,0 +1,8 @@
+#pragma once
+
+struct IntVector2
+{
+    int x, y;
+
+    bool operator==(const IntVector2& other) const;
+};
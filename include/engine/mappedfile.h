@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Minesweeper
+{
+
+    class MappedFile
+        // Read-only view of a whole file through the OS page cache (mmap, or MapViewOfFile on
+        // Windows), so reading it costs no copy and only the pages touched are loaded.
+    {
+    private:
+        const std::byte* m_data = nullptr;
+        size_t m_size = 0;
+
+#if defined(_WIN32)
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#else
+        int m_file = -1;
+#endif
+
+    private:
+        void Close();
+
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string& filePath);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        const std::byte* GetData() const;
+        size_t GetSize() const;
+    };
+};
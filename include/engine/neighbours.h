@@ -0,0 +1,71 @@
+#pragma once
+
+#include "engine/intvector2.h"
+
+namespace Minesweeper
+{
+
+    constexpr int neighbourOffsetsX[8] = { -1, -1, -1,  0, 0,  1, 1, 1 };
+    constexpr int neighbourOffsetsY[8] = { -1,  0,  1, -1, 1, -1, 0, 1 };
+
+    inline bool IsInteriorTile(const IntVector2 coords, const IntVector2 dimensions)
+        // Interior tiles have all 8 neighbours on the board.
+    {
+        return coords.x > 0 && coords.x < dimensions.x - 1 && coords.y > 0 && coords.y < dimensions.y - 1;
+    }
+
+    template <bool IsInterior, typename T_Callback>
+    inline void ForEachNeighbour(const IntVector2 coords, const IntVector2 dimensions, T_Callback&& callback)
+        // Calls callback(IntVector2) for each neighbour. When IsInterior is true the caller
+        // guarantees all neighbours exist and the bounds checks are compiled out.
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            const IntVector2 neighbour = { coords.x + neighbourOffsetsX[i], coords.y + neighbourOffsetsY[i] };
+
+            if constexpr (!IsInterior)
+            {
+                if (neighbour.x < 0 || neighbour.x >= dimensions.x || neighbour.y < 0 || neighbour.y >= dimensions.y) continue;
+            }
+
+            callback(neighbour);
+        }
+    }
+
+    template <typename T_Callback>
+    inline void ForEachNeighbour(const IntVector2 coords, const IntVector2 dimensions, T_Callback&& callback)
+    {
+        if (IsInteriorTile(coords, dimensions)) ForEachNeighbour<true>(coords, dimensions, callback);
+        else ForEachNeighbour<false>(coords, dimensions, callback);
+    }
+
+    template <bool IsInterior, typename T_Callback>
+    inline void ForEachNeighbourIndex(const int index, const IntVector2 dimensions, T_Callback&& callback)
+        // Row-major index version of ForEachNeighbour, calls callback(int index).
+    {
+        if constexpr (IsInterior)
+        {
+            const int w = dimensions.x;
+            const int offsets[8] = { -w - 1, -w, -w + 1, -1, 1, w - 1, w, w + 1 };
+
+            for (const int offset : offsets) callback(index + offset);
+        }
+        else
+        {
+            const IntVector2 coords = { index % dimensions.x, index / dimensions.x };
+
+            ForEachNeighbour<false>(coords, dimensions, [&](const IntVector2 neighbour) {
+                callback(neighbour.y * dimensions.x + neighbour.x);
+            });
+        }
+    }
+
+    template <typename T_Callback>
+    inline void ForEachNeighbourIndex(const int index, const IntVector2 dimensions, T_Callback&& callback)
+    {
+        const IntVector2 coords = { index % dimensions.x, index / dimensions.x };
+
+        if (IsInteriorTile(coords, dimensions)) ForEachNeighbourIndex<true>(index, dimensions, callback);
+        else ForEachNeighbourIndex<false>(index, dimensions, callback);
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "engine/bitplane.h"
+#include "engine/random.h"
+#include <cstdint>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    template <typename T_BitPlane, typename T_Random>
+    void PlaceBombs(T_BitPlane& bombs, const int numberOfBombs, T_Random& random, const std::vector<int>& safeTiles = {})
+        // Floyd's sampling over flat tile indices, using the plane itself as the set of
+        // chosen tiles. When more than half the candidate tiles are bombs the safe tiles are
+        // sampled instead, so the cost is O(min(bombs, safe tiles)) draws plus a bulk fill.
+        // safeTiles must be sorted ascending and never receive a bomb. bombs, a BitPlane or
+        // FixedBitPlane, must be all clear on entry.
+    {
+        const size_t numberOfCandidates = bombs.Size() - safeTiles.size();
+        const bool isDense = (size_t)numberOfBombs > numberOfCandidates / 2;
+        const size_t numberToChoose = isDense ? numberOfCandidates - numberOfBombs : numberOfBombs;
+
+        const auto toTileIndex = [&safeTiles](size_t candidate) {
+            for (const int safeTile : safeTiles)
+            {
+                if ((size_t)safeTile > candidate) break;
+                candidate++;
+            }
+            return candidate;
+        };
+
+        if (isDense)
+        {
+            bombs.Fill(true);
+            for (const int safeTile : safeTiles) bombs.Reset(safeTile);
+        }
+
+        for (size_t j = numberOfCandidates - numberToChoose; j < numberOfCandidates; j++)
+        {
+            const size_t candidate = toTileIndex(UniformBelow(random, (std::uint32_t)(j + 1)));
+            const bool isAlreadyChosen = bombs.Get(candidate) != isDense;
+
+            bombs.Set(isAlreadyChosen ? toTileIndex(j) : candidate, !isDense);
+        }
+    }
+};
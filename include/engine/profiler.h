@@ -0,0 +1,127 @@
+#pragma once
+
+// Scoped timing zones and allocation counts, built only with -DMINESWEEPER_PROFILE=ON.
+// Otherwise PROFILE_ZONE expands to nothing and none of this is compiled.
+
+#ifndef MINESWEEPER_PROFILE
+#define MINESWEEPER_PROFILE 0
+#endif
+
+#if MINESWEEPER_PROFILE
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    class Profiler
+        // Every thread records finished zones into its own ring buffer without locking; the
+        // main thread drains them once per frame in EndFrame(), which also takes the frame
+        // time and the number of allocations made (by any thread) since the previous frame.
+    {
+    public:
+        struct ZoneEvent
+        {
+            const char* name;   // Must outlive the profiler, in practice a string literal.
+            std::int64_t startNanoseconds;
+            std::int64_t endNanoseconds;
+        };
+
+        struct ZoneTotal
+        {
+            const char* name;
+            double milliseconds;
+            int count;
+        };
+
+        struct FrameStats
+        {
+            double milliseconds;
+            long long allocations;
+        };
+
+        class Zone
+        {
+        private:
+            const char* m_name;
+            std::int64_t m_startNanoseconds;
+
+        public:
+            explicit Zone(const char* name);
+            ~Zone();
+
+            Zone(const Zone&) = delete;
+            Zone& operator=(const Zone&) = delete;
+        };
+
+        static constexpr size_t ringCapacity = 1 << 14;
+        static constexpr size_t frameHistorySize = 240;
+        static constexpr size_t maxTraceEvents = 1 << 20;
+
+    private:
+        struct ThreadRing
+            // Single producer (the owning thread), single consumer (EndFrame).
+        {
+            int threadIndex;
+            std::vector<ZoneEvent> events = std::vector<ZoneEvent>(ringCapacity);
+            std::atomic<std::uint64_t> head = 0;
+            std::atomic<std::uint64_t> tail = 0;
+        };
+
+        struct TraceEvent
+        {
+            ZoneEvent zone;
+            int threadIndex;
+        };
+
+        // Only taken when a thread records its first zone and when draining.
+        std::mutex m_ringsMutex;
+        std::vector<std::unique_ptr<ThreadRing>> m_rings;
+
+        std::atomic<long long> m_numberOfDroppedEvents = 0;
+
+        std::int64_t m_startNanoseconds;
+        std::int64_t m_lastFrameNanoseconds;
+        long long m_lastAllocations = 0;
+
+        std::vector<FrameStats> m_frames;   // Ring of the last frameHistorySize frames.
+        size_t m_nextFrame = 0;
+        std::vector<ZoneTotal> m_lastFrameZones;
+        std::vector<TraceEvent> m_trace;
+
+    private:
+        Profiler();
+
+        ThreadRing& GetThreadRing();
+        void Record(const ZoneEvent& event);
+
+    public:
+        static Profiler& Get();
+        static std::int64_t Now();
+        static long long GetNumberOfAllocations();
+
+        void EndFrame();
+
+        std::vector<FrameStats> GetFrames() const;
+        const std::vector<ZoneTotal>& GetLastFrameZones() const;
+        long long GetNumberOfDroppedEvents() const;
+
+        void WriteChromeTrace(const std::string& filePath) const;
+    };
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_ZONE(name) const ::Minesweeper::Profiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+#else
+
+#define PROFILE_ZONE(name) ((void)0)
+
+#endif
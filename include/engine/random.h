@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace Minesweeper
+{
+
+    // Small, fast generators with fully specified output so a seed produces the
+    // same sequence on every platform and standard library.
+
+    class SplitMix64
+    {
+    private:
+        std::uint64_t m_state;
+
+    public:
+        using result_type = std::uint64_t;
+
+        explicit SplitMix64(const std::uint64_t seed)
+            : m_state(seed)
+        {
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+    };
+
+    class Xoshiro256StarStar
+    {
+    private:
+        std::uint64_t m_state[4];
+
+        static std::uint64_t RotateLeft(const std::uint64_t value, const int shift)
+        {
+            return (value << shift) | (value >> (64 - shift));
+        }
+
+    public:
+        using result_type = std::uint64_t;
+
+        explicit Xoshiro256StarStar(const std::uint64_t seed)
+        {
+            SplitMix64 seeder(seed);
+            for (std::uint64_t& word : m_state) word = seeder();
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()()
+        {
+            const std::uint64_t result = RotateLeft(m_state[1] * 5, 7) * 9;
+            const std::uint64_t t = m_state[1] << 17;
+
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = RotateLeft(m_state[3], 45);
+
+            return result;
+        }
+    };
+
+    inline std::uint64_t DeriveSeed(const std::uint64_t seed, const std::uint64_t stream)
+        // Seed for an independent sub-stream (one per attempt, game, band...) of seed.
+    {
+        SplitMix64 mixer(seed ^ SplitMix64(stream)());
+        return mixer();
+    }
+
+    template <typename T_Random>
+    std::uint32_t UniformBelow(T_Random& random, const std::uint32_t bound)
+        // Unbiased value in [0, bound) using Lemire's multiply-shift method. Needs a
+        // generator with 64 random bits per call.
+    {
+        static_assert(T_Random::min() == 0 && T_Random::max() == std::numeric_limits<std::uint64_t>::max(),
+            "T_Random must produce 64 random bits");
+
+        std::uint64_t product = (random() >> 32) * bound;
+        std::uint32_t low = (std::uint32_t)product;
+
+        if (low < bound)
+        {
+            const std::uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold)
+            {
+                product = (random() >> 32) * bound;
+                low = (std::uint32_t)product;
+            }
+        }
+
+        return (std::uint32_t)(product >> 32);
+    }
+
+    inline std::uint64_t IntegerSquareRoot(const std::uint64_t value)
+        // floor(sqrt(value)) for value below 2^62, the same on every platform.
+    {
+        std::uint64_t root = (std::uint64_t)std::sqrt((double)value);
+        while (root * root > value) root--;
+        while ((root + 1) * (root + 1) <= value) root++;
+
+        return root;
+    }
+
+    template <typename T_Random>
+    std::uint32_t SampleHypergeometric(T_Random& random, const std::uint32_t draws, const std::uint32_t marked, const std::uint32_t population)
+        // Number of marked items among draws items taken without replacement from population
+        // items, marked of them marked. Exact when the smaller of draws and marked is at most
+        // 1024 (after the symmetries below), otherwise a normal approximation, which costs the
+        // same for any size. Integer arithmetic only, so a seed gives the same value everywhere.
+    {
+        if (draws > population - draws) return marked - SampleHypergeometric(random, population - draws, marked, population);
+        if (marked > population - marked) return draws - SampleHypergeometric(random, draws, population - marked, population);
+
+        // The distribution is symmetric in draws and marked.
+        const std::uint32_t fewer = std::min(draws, marked);
+        const std::uint32_t more = std::max(draws, marked);
+
+        if (fewer <= 1024)
+        {
+            std::uint32_t count = 0;
+            for (std::uint32_t i = 0; i < fewer; i++)
+            {
+                if (UniformBelow(random, population - i) < more - count) count++;
+            }
+
+            return count;
+        }
+
+        // Both are at most half the population, so the mean is below 2^30 and fits 32.32 fixed
+        // point. The variance and the standard deviation get 16 fractional bits, the normal
+        // variable 24.
+        const std::uint64_t product = (std::uint64_t)draws * marked;
+        const std::uint64_t mean = product / population;
+        const std::uint64_t meanFraction = ((product % population) << 32) / population;
+
+        // x * a / b, rounded down, for a <= b < 2^32 without overflowing.
+        const auto multiplyDivide = [](const std::uint64_t x, const std::uint64_t a, const std::uint64_t b) {
+            return x / b * a + x % b * a / b;
+        };
+
+        const std::uint64_t scaledMean = multiplyDivide((std::uint64_t)draws << 16, marked, population);
+        const std::uint64_t variance = multiplyDivide(multiplyDivide(scaledMean, population - marked, population), population - draws, population - 1);
+        const std::int64_t deviation = (std::int64_t)IntegerSquareRoot(variance << 16);
+
+        // Irwin-Hall: the sum of twelve uniform variables, less six, is close to a standard normal one.
+        std::int64_t normal = -6 * (std::int64_t(1) << 24);
+        for (int i = 0; i < 12; i++) normal += (std::int64_t)(random() >> 40);
+
+        const std::int64_t value = (std::int64_t)((mean << 32) + meanFraction) + ((normal * deviation) >> 8);
+        return (std::uint32_t)std::clamp<std::int64_t>((value + (std::int64_t(1) << 31)) >> 32, 0, fewer);
+    }
+};
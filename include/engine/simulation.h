@@ -0,0 +1,97 @@
+#pragma once
+
+#include "engine/board.h"
+#include "engine/generator.h"
+#include "engine/random.h"
+#include "engine/snapshot.h"
+#include "engine/solver.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    class Policy
+        // Decides which tile a simulated player reveals next. Each worker thread owns its
+        // own instance, so implementations may keep per-game state.
+    {
+    public:
+        virtual ~Policy() = default;
+
+        virtual void StartGame(const Board&) {}
+        virtual int ChooseTile(const Board& board, Xoshiro256StarStar& random) = 0;
+        virtual void OnReveal(const Board&) {}
+    };
+
+    class RandomPolicy : public Policy
+        // Reveals a uniformly random covered tile.
+    {
+    public:
+        int ChooseTile(const Board& board, Xoshiro256StarStar& random) override;
+    };
+
+    class SolverPolicy : public Policy
+        // Reveals tiles the Solver proves safe and otherwise guesses the covered tile
+        // with the lowest bomb probability.
+    {
+    private:
+        Solver m_solver;
+
+    public:
+        void StartGame(const Board& board) override;
+        int ChooseTile(const Board& board, Xoshiro256StarStar& random) override;
+        void OnReveal(const Board& board) override;
+    };
+
+    enum class PolicyType
+    {
+        RANDOM,
+        SOLVER
+    };
+
+    std::unique_ptr<Policy> CreatePolicy(const PolicyType type);
+
+    struct SimulationConfig
+    {
+        IntVector2 dimensions = { 9, 9 };
+        float bombDensity = 0.15f;
+        int numberOfGames = 1000;
+        PolicyType policy = PolicyType::SOLVER;
+        GenerationOptions generationOptions = {};
+        std::uint64_t seed = 0;
+        int numberOfThreads = 0;    // 0 uses every hardware thread.
+
+        // Game i continues snapshot i (modulo its size) instead of generating a board, so
+        // dimensions, density and generation options are not used.
+        const SnapshotCorpus* corpus = nullptr;
+
+        // Keeps the position after every game's first click in SimulationResult::corpus.
+        bool isCorpusRecorded = false;
+    };
+
+    struct SimulationResult
+    {
+        int numberOfGames = 0;
+        int numberOfWins = 0;
+        long long numberOfClicks = 0;
+        double totalGameSeconds = 0.0;  // Sum of the time spent in each game.
+        double wallSeconds = 0.0;
+        std::vector<std::byte> corpus;  // Snapshots in game order, see SimulationConfig::isCorpusRecorded.
+
+        double GetWinRate() const;
+        double GetMeanClicks() const;
+        double GetMeanGameMilliseconds() const;
+        double GetGamesPerSecond() const;
+    };
+
+    struct GameResult
+    {
+        bool isWon = false;
+        int numberOfClicks = 0;
+    };
+
+    GameResult PlayGame(const SimulationConfig& config, const int gameIndex, Board& board, Policy& policy, std::vector<std::byte>* startingPosition = nullptr);
+    SimulationResult RunSimulation(const SimulationConfig& config);
+};
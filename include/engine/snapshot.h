@@ -0,0 +1,82 @@
+#pragma once
+
+#include "engine/board.h"
+#include "engine/mappedfile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    // Binary snapshot of a game: a fixed 64 byte header followed by the bomb, covered and
+    // flagged planes exactly as BitPlane stores them (little-endian 64-bit words, row-major).
+    // Restoring is a header check and three bulk copies; adjacency counts are rebuilt from
+    // the bombs. Snapshots are self-delimiting, so a corpus is just snapshots back to back.
+
+    struct SnapshotHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t headerSize;
+        std::int32_t width;
+        std::int32_t height;
+        std::uint64_t seed;
+        std::int64_t elapsedMilliseconds;
+        std::int32_t numberOfBombs;
+        std::int32_t numberOfBombsLeft;
+        std::int32_t numberOfFlagsLeft;
+        std::int32_t numberOfCoveredSafeTiles;
+        std::uint32_t flags;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(SnapshotHeader) == 64, "The snapshot header is part of the file format");
+
+    struct SnapshotInfo
+        // What a snapshot records beside the board itself.
+    {
+        std::uint64_t seed = 0;
+        std::int64_t elapsedMilliseconds = 0;
+    };
+
+    class Snapshot
+    {
+    public:
+        static constexpr char magic[8] = { 'M', 'S', 'W', 'P', 'S', 'N', 'A', 'P' };
+        static constexpr std::uint32_t version = 1;
+
+        enum Flags : std::uint32_t
+        {
+            IS_GENERATED = 1 << 0,
+            IS_BOMB_TRIGGERED = 1 << 1
+        };
+
+    public:
+        static size_t GetSize(const IntVector2 dimensions);
+
+        static void Write(const Board& board, const SnapshotInfo& info, std::vector<std::byte>& buffer);
+        static SnapshotHeader ReadHeader(const std::byte* data, const size_t size);
+        static size_t Read(const std::byte* data, const size_t size, Board& board, SnapshotInfo& info);
+
+        static void Save(const std::string& filePath, const Board& board, const SnapshotInfo& info);
+        static void Load(const std::string& filePath, Board& board, SnapshotInfo& info);
+        static SnapshotHeader LoadHeader(const std::string& filePath);
+    };
+
+    class SnapshotCorpus
+        // Many snapshots in one mapped file. Opening only walks the headers to index them;
+        // boards are copied out on demand, so workers can read from it concurrently.
+    {
+    private:
+        MappedFile m_file;
+        std::vector<size_t> m_offsets;
+
+    public:
+        explicit SnapshotCorpus(const std::string& filePath);
+
+        int GetNumberOfSnapshots() const;
+        void Read(const int snapshotIndex, Board& board, SnapshotInfo& info) const;
+    };
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "engine/bitplane.h"
+#include "engine/board.h"
+#include "engine/floodfill.h"
+#include <memory_resource>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    class Solver
+        // Deterministic solver that only uses what a player can see: uncovered numbers,
+        // covered tiles and the total number of bombs. Never guesses.
+        //
+        // Deductions run in three stages: single constraints, subset/superset pairs of
+        // constraints, then exact enumeration of each independent frontier component.
+        // State is kept between reveals; Update() only re-evaluates the constraints and
+        // components around the newly revealed tiles.
+    {
+    private:
+        struct Constraint
+            // numberOfBombs of the listed unknown tiles are bombs.
+        {
+            int tiles[8];
+            int numberOfTiles;
+            int numberOfBombs;
+        };
+
+        struct Component
+            // Unknown frontier tiles linked by shared constraints. solutions[k] is the number
+            // of layouts with k bombs and tileBombSolutions[k * size + i] how many of them
+            // have a bomb on tiles[i].
+        {
+            std::vector<int> tiles;
+            std::vector<double> solutions;
+            std::vector<double> tileBombSolutions;
+            std::vector<float> localProbabilities; // Used instead when too big to enumerate.
+            bool isEnumerated = false;
+            bool isAlive = false;
+        };
+
+        struct ComponentTile
+        {
+            int component;
+            int localIndex;
+        };
+
+        BitPlane m_knownBombs;
+        BitPlane m_knownSafe;
+        BitPlane m_queued;
+        int m_numberOfKnownBombs = 0;
+
+        std::vector<int> m_queue;
+        std::vector<int> m_safeTiles;
+        std::vector<int> m_regroupTiles;
+
+        // Components are recycled through m_freeComponents, Reset() included, so their
+        // vectors keep their capacity from one game to the next.
+        std::vector<Component> m_components;
+        std::vector<int> m_freeComponents;
+        std::vector<Constraint> m_constraints;
+
+        // Hash nodes come from this pool and go back to it when erased or cleared, so once
+        // warmed up a game makes no heap allocation for them. Declared first to outlive them.
+        std::pmr::unsynchronized_pool_resource m_nodeResource;
+        std::pmr::unordered_map<int, ComponentTile> m_componentOfTile{ &m_nodeResource };
+        std::pmr::unordered_set<int> m_componentConstraints{ &m_nodeResource };
+
+        int m_remainingBombs = 0;
+        int m_numberOfUnknownTiles = 0;
+        double m_bombRatio = 0.0;
+        float m_interiorProbability = 0.0f;
+
+    private:
+        bool IsConstraintTile(const Board& board, const int index) const;
+        bool IsUnknown(const Board& board, const int index) const;
+        Constraint GetConstraint(const Board& board, const int index) const;
+
+        void Enqueue(const int index);
+        void EnqueueConstraintsAround(const Board& board, const int index);
+        void InvalidateComponent(const int index);
+        void MarkSafe(const Board& board, const int index);
+        void MarkBomb(const Board& board, const int index);
+
+        void ApplyConstraint(const Board& board, const Constraint& constraint);
+        void ApplySubsetRule(const Board& board, const Constraint& subset, const Constraint& superset);
+        void Propagate(const Board& board);
+        void ApplyBombCountRule(const Board& board);
+
+        void BuildComponent(const Board& board, const int seedTile);
+        void Enumerate(Component& component, const std::vector<Constraint>& constraints);
+        void ApplyComponentCertainties(const Board& board, const Component& component);
+        void RebuildComponents(const Board& board);
+        void GetValidBombRange(const Component& component, int& minimumBombs, int& maximumBombs) const;
+        void UpdateInteriorProbability();
+
+        void Settle(const Board& board);
+
+    public:
+        void Reset(const Board& board);
+        void Update(const Board& board, const std::vector<TileSpan>& revealedTiles);
+        bool Solve(Board& board);
+
+        const std::vector<int>& GetSafeTiles() const;
+        bool IsKnownSafe(const int index) const;
+        bool IsKnownBomb(const int index) const;
+        float GetBombProbability(const Board& board, const int index) const;
+    };
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Minesweeper
+{
+
+    class ThreadPool
+        // Work-stealing pool. Every worker has its own task deque: it pops its own work from
+        // the back and, when that runs dry, steals from the front of the others.
+    {
+    private:
+        struct WorkQueue
+        {
+            std::deque<std::function<void()>> tasks;
+            std::mutex mutex;
+        };
+
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_stateMutex;
+        std::condition_variable m_workAvailable;
+        std::condition_variable m_workDone;
+        std::atomic<int> m_numberOfQueuedTasks = 0;
+        std::atomic<int> m_numberOfUnfinishedTasks = 0;
+        std::atomic<int> m_nextQueue = 0;
+        bool m_isStopping = false;
+
+    private:
+        bool TryPop(const int workerIndex, std::function<void()>& task);
+        void RunWorker(const int workerIndex);
+
+    public:
+        explicit ThreadPool(const int numberOfThreads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        int GetNumberOfThreads() const;
+        static int GetWorkerIndex();
+
+        void Submit(std::function<void()> task);
+        void Wait();
+
+        template <typename T_Callback>
+        void ParallelFor(const int count, T_Callback&& callback)
+            // Calls callback(index, workerIndex) for every index in [0, count) and waits.
+            // Indices are handed out in chunks so idle workers have something to steal.
+        {
+            const int chunkSize = std::max(1, count / (GetNumberOfThreads() * 8));
+
+            for (int begin = 0; begin < count; begin += chunkSize)
+            {
+                const int end = std::min(begin + chunkSize, count);
+
+                Submit([&callback, begin, end]() {
+                    const int workerIndex = GetWorkerIndex();
+                    for (int i = begin; i < end; i++) callback(i, workerIndex);
+                });
+            }
+
+            Wait();
+        }
+    };
+};
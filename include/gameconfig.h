@@ -0,0 +1,41 @@
+#pragma once
+
+#include "engine/intvector2.h"
+#include <string>
+
+namespace Minesweeper
+{
+
+    struct GameConfig
+    {
+        IntVector2 boardDimensions = { 9, 9 };
+        int numberOfBombs = -1;     // Taken from bombDensity when negative.
+        float bombDensity = 0.15f;
+
+        int tileSize = 0;           // Pixels, without the margin. 0 fits the board to the window.
+        IntVector2 windowDimensions = { 800, 600 };
+
+        std::string replayFilePath;
+        bool isHelpRequested = false;
+
+        int GetNumberOfBombs() const;
+    };
+
+    struct TileLayout
+    {
+        IntVector2 dimensions;
+        IntVector2 margin;
+    };
+
+    // Settings come from the config file first (--config FILE, or minesweeper.cfg when it
+    // exists), then from the command line, each later setting overriding earlier ones. The
+    // file holds one "option = value" per line, options named as the flags without "--".
+    extern const char* defaultConfigFilePath;
+
+    void ApplyConfigOption(GameConfig& config, const std::string& option, const std::string& value);
+    void LoadConfigFile(GameConfig& config, const std::string& filePath);
+    GameConfig ParseGameConfig(const int argc, const char* const* argv);
+    void PrintGameUsage();
+
+    TileLayout GetTileLayout(const GameConfig& config);
+};
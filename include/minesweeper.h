@@ -2,9 +2,15 @@
 
 #include "raylib.h"
 #include "gameboard.h"
+#include "renderer.h"
+#include "engine/actionlog.h"
+#include "engine/board.h"
+#include "engine/generator.h"
+#include "engine/snapshot.h"
+#include "engine/solver.h"
+#include <array>
+#include <cstdint>
 #include <vector>
-#include <random>
-#include <set>
 #include <string>
 #include <map>
 #include <memory>
@@ -14,80 +20,140 @@ namespace Minesweeper
 
     extern const std::string texturesBaseFilePath;
     extern const std::map<std::string, std::string> textureFilePaths;
-    extern Gameboard::AssetsHandler assets;
+    // Assets the game refers to directly. Their names are registered with the handlers in this
+    // order before anything is loaded, so the handles below are fixed at compile time.
+    namespace TextureIds
+    {
+        constexpr Gameboard::AssetHandle<Texture2D> COVERED_TILE = { 0 };
 
+        inline const std::vector<std::string> names = { "covered-tile" };
+    };
 
-    class Tile : public Gameboard::DrawableTexture
+    namespace FontIds
     {
-    public:
-        enum class ContentOption : int
-        {
-            BOMB = -1,
-            EMPTY = 0,
-            ONE = 1,
-            TWO = 2,
-            THREE = 3,
-            FOUR = 4,
-            FIVE = 5,
-            SIX = 6,
-            SEVEN = 7,
-            EIGHT = 8
-        };
+        constexpr Gameboard::AssetHandle<Font> ARIAL_ROUNDED = { 0 };
 
-    private:
-        ContentOption m_entityOption = ContentOption::EMPTY;
-        std::shared_ptr<Texture2D> m_contentTexture = assets.textures.Get("empty-tile");
-        const std::shared_ptr<Texture2D> m_flagTexture = assets.textures.Get("flag");
-        bool m_isCovered = true;
-        bool m_isFlagged = false;
+        inline const std::vector<std::string> names = { "arialroundedmtbold" };
+    };
 
-    public:
-        Tile(const IntVector2 dimensions, const IntVector2 margin);
+    namespace SoundIds
+    {
+        constexpr Gameboard::AssetHandle<Sound> UNCOVER = { 0 };
+        constexpr Gameboard::AssetHandle<Sound> EXPLOSION = { 1 };
+        constexpr Gameboard::AssetHandle<Sound> FLAG_UP = { 2 };
+        constexpr Gameboard::AssetHandle<Sound> FLAG_DOWN = { 3 };
 
-        ContentOption GetContentOption() const;
-        void SetContentOption(ContentOption contentOption);
+        inline const std::vector<std::string> names = { "uncover", "explosion", "flag-up", "flag-down" };
+    };
 
-        std::shared_ptr<Texture2D> GetContentTexture() const;
-        void SetContentTexture(std::shared_ptr<Texture2D> textureFilePath);
+    extern Gameboard::AssetsHandler assets;
+    extern Gameboard::TextureAtlas atlas;
 
-        bool IsTileCovered() const;
-        void ToggleCovered();
 
-        bool IsTileFlagged() const;
-        void ToggleFlag();
+    class Tile : public Gameboard::Drawable
+        // Geometry shared by every tile of a grid. Per tile state lives in the Board and
+        // textures are picked from it when rendering, so no Tile is stored per cell.
+    {
+    public:
+        using ContentOption = Minesweeper::ContentOption;
 
+    public:
+        Tile(const IntVector2 dimensions, const IntVector2 margin);
+
+        void Render(const Texture2D& texture, const IntVector2 positionOnScreen) const;
         void Render() const override;
     };
     
-    class MinesweeperGrid : public Gameboard::Grid<Tile>
+    class MinesweeperGrid : public Gameboard::GridLayout
     {
     private:
-        typedef std::vector<std::vector<Tile>> TileGrid;
-        std::set<std::pair<int, int>> m_bombCoordinates;
+        Board m_board;
+
+        // The board is generated on the first left click so it can be built around it.
+        GenerationOptions m_generationOptions;
+        std::uint64_t m_seed;
+
+        // Time played since the board was generated, kept in snapshots.
+        double m_elapsedSeconds = 0.0;
+
+        // Every action that changes the board is logged here, the file being created on the first one.
+        std::string m_actionLogFilePath;
+        std::unique_ptr<ActionLogWriter> m_actionLog;
+
+        // While a log is replayed its actions are applied as the replay clock passes their time.
+        std::unique_ptr<ActionLogReader> m_replayLog;
+        size_t m_nextReplayAction = 0;
+        double m_replaySeconds = 0.0;
+
+        // Looked up once from the atlas, and again by RefreshTextures() when it changes.
+        Gameboard::AtlasRegion m_coveredRegion;
+        Gameboard::AtlasRegion m_flagRegion;
+        Gameboard::AtlasRegion m_incorrectRegion;
+        Gameboard::AtlasRegion m_bombRegion;
+        Gameboard::AtlasRegion m_whiteRegion;
+        std::array<Gameboard::AtlasRegion, 9> m_numberRegions;
 
-        float m_bombDensity = 0.15f;
-        int m_numberOfBombs;
-        int m_numberOfBombsLeft;
-        int m_numberOfFlagsLeft;
+        // Refilled every frame; kept as a member so its buffers are reused.
+        mutable Gameboard::QuadBatch m_quadBatch = Gameboard::QuadBatch(atlas);
 
-        bool m_isBombTriggered = false;
+        // Tiles are redrawn into it only when marked dirty by a reveal, a flag or DisplayBombs().
+        mutable Gameboard::GridRenderCache m_renderCache;
+
+        bool m_areBombsDisplayed = false;
+
+        // Identity until the player pans or zooms, so the grid first shows where it is anchored.
+        Gameboard::GridCamera m_camera;
+
+        // Kept current after every reveal while hints are shown.
+        Solver m_solver;
+        bool m_areHintsShown = false;
 
     private:
-        int GetNumberOfBombsAroundTile(const Tile& tile) const;
-        void PlaceBombsOnBoard();
-        void ClearEmptyNeighbours(const Tile& homeTile);
-        bool IsTileUnderMouse(const Tile& tile, const Vector2& mousePosition) const;
-        void HandleRightClick(Tile& tile);
-        void HandleLeftClick(Tile& tile);
+        const Gameboard::AtlasRegion& GetContentRegion(const int index) const;
+        Rectangle GetCellRectangle(const IntVector2 coords) const;
+        Camera2D GetCamera2D() const;
+        void LimitZoomOut();
+        bool GetCellUnderMouse(IntVector2& coords) const;
+        void RenderTile(const IntVector2 coords) const;
+        void RenderTiles(const IntVector2 first, const IntVector2 last) const;
+        void MarkRevealedTilesDirty();
+        void RenderHints(const IntVector2 first, const IntVector2 last) const;
+        void RenderHover() const;
+        void PlayTileSound(const Gameboard::AssetHandle<Sound> sound) const;
+        void RecordAction(const ActionType type, const IntVector2 coords);
+        void OnTilesRevealed(const Board::RevealResult result);
+        void HandleRightClick(const IntVector2 coords);
+        void HandleLeftClick(const IntVector2 coords);
+        void HandleChord(const IntVector2 coords);
 
     public:
-        MinesweeperGrid(const IntVector2 dimensions, const Tile sampleTile, const Gameboard::AnchorPoints anchorPoint, const IntVector2 position);
+        MinesweeperGrid(const IntVector2 dimensions, const int numberOfBombs, const Tile sampleTile, const Gameboard::AnchorPoints anchorPoint, const IntVector2 position, const GenerationOptions generationOptions = {});
 
+        static std::uint64_t NewSeed();
+        void Reset(const IntVector2 dimensions, const int numberOfBombs, const Tile sampleTile, const std::uint64_t seed, const GenerationOptions generationOptions = {});
+
+        void DisplayGrid() const;
         void ProcessMouseInput() override;
+        void UpdateCamera();
+
+        void UpdateTimer();
+        bool IsInProgress() const;
+        bool IsWon() const;
+        bool IsOver() const;
+        std::uint64_t GetSeed() const;
+        void SaveSnapshot(const std::string& filePath) const;
+        void LoadSnapshot(const std::string& filePath);
+
+        void StartRecording(const std::string& filePath);
+        void StartReplay(const std::string& filePath);
+        bool IsReplaying() const;
+        void UpdateReplay();
 
         bool IsBombTriggered() const;
         int GetNumberOfFlagsLeft() const;
         int GetNumberOfBombsLeft() const;
         void DisplayBombs();
+        void ToggleHints();
+        void RefreshTextures();
     };
 };
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "raylib.h"
+#include "engine/intvector2.h"
+#include "engine/profiler.h"
+
+#if MINESWEEPER_PROFILE
+
+namespace Gameboard
+{
+
+    // Panel with a histogram of recent frame times, allocations in the last frame and the
+    // zones that took longest in it.
+    void DrawProfilerOverlay(const Minesweeper::Profiler& profiler, const IntVector2 position);
+};
+
+#endif
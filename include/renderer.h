@@ -0,0 +1,181 @@
+#pragma once
+
+#include "raylib.h"
+#include "engine/grid.h"
+#include "engine/profiler.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Gameboard
+{
+
+    struct AtlasRegion
+    {
+        int page = 0;
+        Rectangle source = { 0, 0, 0, 0 };
+    };
+
+    class TextureAtlas
+        // Packs images into a few large pages so drawing them needs no texture switches.
+        // Every image is scaled to the same square cell, which suits tile sprites. Images can be
+        // added one at a time; pages are composed in CPU memory and sent to the GPU by Upload().
+    {
+    public:
+        static constexpr int cellSize = 128;
+        static constexpr int pageSize = 1024;
+        static constexpr const char* whiteRegionName = "white";
+        static constexpr const char* placeholderRegionName = "placeholder";
+
+    private:
+        std::vector<Image> m_pageImages;
+        std::vector<Texture2D> m_pages;
+        std::map<std::string, AtlasRegion> m_regions;
+        int m_numberOfCells = 0;
+        bool m_isUploaded = true;
+
+    private:
+        void AddCell(const std::string& id, const Image& image);
+        void AddBuiltInCells();
+
+    public:
+        ~TextureAtlas();
+
+        void Add(const std::string& id, const Image& image);
+        void Upload();
+        void LoadAll(FilePathList imagesFilePaths);
+        void UnloadAll();
+
+        AtlasRegion Get(const std::string& id) const;
+        const Texture2D& GetPage(const int page) const;
+        int GetNumberOfPages() const;
+    };
+
+    class QuadBatch
+        // Collects textured quads for a frame and draws them page by page through rlgl, so a
+        // whole grid becomes one raylib batch per atlas page instead of one per texture switch.
+    {
+    private:
+        struct Quad
+        {
+            Rectangle source;
+            Rectangle destination;
+            Color tint;
+        };
+
+        const TextureAtlas& m_atlas;
+        std::vector<std::vector<Quad>> m_quadsByPage;
+
+    public:
+        explicit QuadBatch(const TextureAtlas& atlas);
+
+        void Add(const AtlasRegion& region, const Rectangle& destination, const Color tint = WHITE);
+        void Draw();
+    };
+
+    class GridRenderCache
+        // Keeps what a grid looks like in render textures, so a frame where nothing changed
+        // costs one textured quad per visible chunk. The grid is split into chunks of cells that
+        // get a texture when first on screen; after that only cells marked dirty are redrawn.
+        // Chunks are drawn at world scale (zoom 1) and at most maxResidentChunks are kept.
+    {
+    public:
+        static constexpr int maxChunkPixels = 1024;
+        static constexpr int maxResidentChunks = 16;
+
+    private:
+        struct Chunk
+        {
+            int index = -1;
+            RenderTexture2D texture = {};
+            bool isFullyDirty = true;
+            std::vector<IntVector2> dirtyCells;
+            std::uint64_t lastUsedFrame = 0;
+        };
+
+        IntVector2 m_gridDimensions;
+        IntVector2 m_pitch;
+        IntVector2 m_chunkDimensions;
+        IntVector2 m_numberOfChunks;
+
+        // Chunks without a texture are implicitly fully dirty, so only resident ones hold state.
+        std::vector<Chunk> m_residentChunks;
+        std::uint64_t m_frame = 0;
+
+    private:
+        void SetLayout(const GridLayout& layout);
+        void UnloadChunks();
+        int GetChunkIndex(const IntVector2 coords) const;
+        void GetChunkCells(const int chunkIndex, IntVector2& first, IntVector2& last) const;
+        void GetChunkRange(const IntVector2 first, const IntVector2 last, IntVector2& firstChunk, IntVector2& lastChunk) const;
+        Chunk* FindResident(const int chunkIndex);
+        Chunk* Acquire(const GridLayout& layout, const int chunkIndex);
+        void BeginChunk(const GridLayout& layout, const Chunk& chunk) const;
+        void EndChunk(QuadBatch& batch, Chunk& chunk) const;
+
+    public:
+        explicit GridRenderCache(const GridLayout& layout);
+        ~GridRenderCache();
+
+        GridRenderCache(const GridRenderCache&) = delete;
+        GridRenderCache& operator=(const GridRenderCache&) = delete;
+
+        void Reset(const GridLayout& layout);
+        void MarkDirty(const IntVector2 coords);
+        void MarkDirty(const int y, const int startX, const int endX);
+        void MarkAllDirty();
+
+        template <typename T_RenderCell>
+        bool Update(const GridLayout& layout, const IntVector2 first, const IntVector2 last, QuadBatch& batch, T_RenderCell&& renderCell)
+            // Brings the chunks over cells [first, last] up to date, redrawing dirty cells by queueing
+            // them into batch through renderCell(IntVector2). Returns false when the range spans more
+            // chunks than can be resident; the caller then has to draw those cells itself.
+        {
+            PROFILE_ZONE("GridRenderCache::Update");
+
+            IntVector2 firstChunk, lastChunk;
+            GetChunkRange(first, last, firstChunk, lastChunk);
+
+            if ((lastChunk.x - firstChunk.x + 1) * (lastChunk.y - firstChunk.y + 1) > maxResidentChunks) return false;
+
+            m_frame++;
+
+            for (int chunkY = firstChunk.y; chunkY <= lastChunk.y; chunkY++)
+            {
+                for (int chunkX = firstChunk.x; chunkX <= lastChunk.x; chunkX++)
+                {
+                    Chunk* chunk = Acquire(layout, chunkY * m_numberOfChunks.x + chunkX);
+                    if (chunk == nullptr) return false;
+                    if (!chunk->isFullyDirty && chunk->dirtyCells.empty()) continue;
+
+                    BeginChunk(layout, *chunk);
+
+                    if (chunk->isFullyDirty)
+                    {
+                        IntVector2 firstCell, lastCell;
+                        GetChunkCells(chunk->index, firstCell, lastCell);
+
+                        for (int y = firstCell.y; y <= lastCell.y; y++)
+                        {
+                            for (int x = firstCell.x; x <= lastCell.x; x++)
+                            {
+                                renderCell(IntVector2{ x, y });
+                            }
+                        }
+                    }
+                    else
+                    {
+                        for (const IntVector2 coords : chunk->dirtyCells) renderCell(coords);
+                    }
+
+                    EndChunk(batch, *chunk);
+                }
+            }
+
+            return true;
+        }
+
+        void Draw(const GridLayout& layout, const IntVector2 first, const IntVector2 last);
+    };
+};
@@ -0,0 +1,179 @@
+#include "assetloader.h"
+#include "engine/profiler.h"
+using namespace Gameboard;
+
+namespace
+{
+    struct FileData
+    {
+        unsigned char* data = nullptr;
+        int size = 0;
+    };
+
+    FileData ReadFile(const std::string& filePath)
+    {
+        FileData file;
+        file.data = LoadFileData(filePath.c_str(), &file.size);
+
+        return file;
+    }
+}
+
+
+AssetLoader::~AssetLoader()
+    // Whatever was decoded but never finalised is released here.
+{
+    m_pool.Wait();
+
+    for (DecodedAsset& asset : m_decoded) asset.discard();
+}
+
+double AssetLoader::GetMillisecondsSince(const Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void AssetLoader::Queue(const char* directoryPath, Decoder decode)
+    // Names and extensions are worked out here, as raylib's file name helpers return static
+    // buffers. Decoders only use the *FromMemory functions, which share no state.
+{
+    FilePathList filePaths = LoadDirectoryFiles(directoryPath);
+
+    for (unsigned int i = 0; i < filePaths.count; i++)
+    {
+        const char* filePath = filePaths.paths[i];
+        if (!IsPathFile(filePath)) continue;
+
+        m_numberOfQueuedAssets++;
+
+        m_pool.Submit([this, decode, filePath = std::string(filePath), id = std::string(GetFileNameWithoutExt(filePath))]() {
+            const Clock::time_point start = Clock::now();
+
+            DecodedAsset asset = decode(filePath, id);
+            asset.decodeMilliseconds = GetMillisecondsSince(start);
+
+            std::lock_guard<std::mutex> lock(m_decodedMutex);
+            m_decoded.push_back(std::move(asset));
+        });
+    }
+
+    UnloadDirectoryFiles(filePaths);
+}
+
+void AssetLoader::QueueTextures(AssetHandler<Texture2D>& textures, TextureAtlas& atlas, const char* directoryPath)
+    // Every image becomes both a texture and an atlas cell. The atlas is uploaded right away
+    // so its placeholder can be drawn before any image is in.
+{
+    m_atlas = &atlas;
+    atlas.Upload();
+
+    Queue(directoryPath, [&textures, &atlas](const std::string& filePath, const std::string& id) {
+        const std::string extension = GetFileExtension(filePath.c_str());
+        const FileData file = ReadFile(filePath);
+
+        const Image image = LoadImageFromMemory(extension.c_str(), file.data, file.size);
+        UnloadFileData(file.data);
+
+        return DecodedAsset{
+            id, 0.0,
+            [&textures, &atlas, id, image]() {
+                if (IsImageReady(image)) textures.Set(id, LoadTextureFromImage(image));
+                atlas.Add(id, image);
+                UnloadImage(image);
+            },
+            [image]() { UnloadImage(image); }
+        };
+    });
+}
+
+void AssetLoader::QueueFonts(AssetHandler<Font>& fonts, const char* directoryPath)
+    // Only the file is read off the main thread; raylib rasterises glyphs as part of creating
+    // the font texture.
+{
+    Queue(directoryPath, [&fonts](const std::string& filePath, const std::string& id) {
+        const std::string extension = GetFileExtension(filePath.c_str());
+        const FileData file = ReadFile(filePath);
+
+        return DecodedAsset{
+            id, 0.0,
+            [&fonts, id, extension, file]() {
+                if (file.data != nullptr) fonts.Set(id, LoadFontFromMemory(extension.c_str(), file.data, file.size, fontSize, nullptr, numberOfFontGlyphs));
+                UnloadFileData(file.data);
+            },
+            [file]() { UnloadFileData(file.data); }
+        };
+    });
+}
+
+void AssetLoader::QueueSounds(AssetHandler<Sound>& sounds, const char* directoryPath)
+    // Decoding (MP3 in particular) is most of the load time, so it is all done by the workers.
+{
+    Queue(directoryPath, [&sounds](const std::string& filePath, const std::string& id) {
+        const std::string extension = GetFileExtension(filePath.c_str());
+        const FileData file = ReadFile(filePath);
+
+        const Wave wave = LoadWaveFromMemory(extension.c_str(), file.data, file.size);
+        UnloadFileData(file.data);
+
+        return DecodedAsset{
+            id, 0.0,
+            [&sounds, id, wave]() {
+                if (IsWaveReady(wave)) sounds.Set(id, LoadSoundFromWave(wave));
+                UnloadWave(wave);
+            },
+            [wave]() { UnloadWave(wave); }
+        };
+    });
+}
+
+bool AssetLoader::Update()
+    // Finalises everything decoded since the last call and logs how long each asset took.
+    // Returns true if anything was loaded, so callers can pick up the new assets.
+{
+    PROFILE_ZONE("AssetLoader::Update");
+
+    if (!m_hasUpdated)
+    {
+        TraceLog(LOG_INFO, "ASSETS: First frame %.2f ms after loading started", GetMillisecondsSince(m_startTime));
+        m_hasUpdated = true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_decodedMutex);
+        std::swap(m_decoded, m_finalizing);
+    }
+
+    if (m_finalizing.empty()) return false;
+
+    for (DecodedAsset& asset : m_finalizing)
+    {
+        const Clock::time_point start = Clock::now();
+        asset.finalize();
+
+        TraceLog(LOG_INFO, "ASSETS: [%s] decoded in %.2f ms, finalised in %.2f ms", asset.id.c_str(), asset.decodeMilliseconds, GetMillisecondsSince(start));
+        m_numberOfLoadedAssets++;
+    }
+
+    m_finalizing.clear();
+
+    if (m_atlas != nullptr) m_atlas->Upload();
+
+    if (IsDone())
+    {
+        TraceLog(LOG_INFO, "ASSETS: %d assets ready %.2f ms after loading started", m_numberOfLoadedAssets, GetMillisecondsSince(m_startTime));
+    }
+
+    return true;
+}
+
+void AssetLoader::Wait()
+    // Blocks until everything queued is loaded.
+{
+    m_pool.Wait();
+    Update();
+}
+
+bool AssetLoader::IsDone() const
+{
+    return m_numberOfLoadedAssets == m_numberOfQueuedAssets;
+}
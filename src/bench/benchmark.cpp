@@ -0,0 +1,286 @@
+#include "benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+using namespace Bench;
+
+const void* volatile Bench::doNotOptimizeSink = nullptr;
+
+namespace
+{
+    std::vector<std::unique_ptr<Benchmark>>& GetRegistry()
+    {
+        static std::vector<std::unique_ptr<Benchmark>> registry;
+        return registry;
+    }
+
+    struct Run
+    {
+        std::string name;
+        long long iterations;
+        double realNanoseconds;   // Per iteration.
+        double cpuNanoseconds;    // Per iteration.
+        double itemsPerSecond;
+    };
+
+    struct Options
+    {
+        std::string filter = ".";
+        std::string format = "console";
+        std::string outputPath;
+        double minTime = 0.5;
+    };
+
+    std::string GetRunName(const Benchmark& benchmark, const std::vector<long long>& arguments)
+    {
+        std::string name = benchmark.GetName();
+        for (const long long argument : arguments) name += "/" + std::to_string(argument);
+        return name;
+    }
+
+    Run Measure(const Benchmark& benchmark, const std::vector<long long>& arguments, const double minTime)
+        // Grows the iteration count until one timed batch lasts at least minTime.
+    {
+        long long iterations = 1;
+
+        while (true)
+        {
+            State state(arguments, iterations);
+            const std::clock_t cpuStart = std::clock();
+            benchmark.GetFunction()(state);
+            const double cpuSeconds = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+            const double seconds = state.GetElapsedSeconds();
+
+            if (seconds >= minTime || iterations >= 1000000000)
+            {
+                return Run{
+                    GetRunName(benchmark, arguments),
+                    iterations,
+                    seconds * 1e9 / iterations,
+                    cpuSeconds * 1e9 / iterations,
+                    state.GetItemsProcessed() > 0 && seconds > 0.0 ? state.GetItemsProcessed() / seconds : 0.0
+                };
+            }
+
+            const double multiplier = seconds > 0.0 ? minTime * 1.4 / seconds : 100.0;
+            iterations = std::max(iterations + 1, (long long)(iterations * std::clamp(multiplier, 2.0, 100.0)));
+        }
+    }
+
+    void PrintConsole(const Run& run)
+    {
+        std::printf("%-40s %15.0f ns %15.0f ns %12lld", run.name.c_str(), run.realNanoseconds, run.cpuNanoseconds, run.iterations);
+        if (run.itemsPerSecond > 0.0) std::printf(" items_per_second=%.4g/s", run.itemsPerSecond);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+    void WriteJson(std::FILE* file, const char* executable, const std::vector<Run>& runs)
+        // Same layout as Google Benchmark's JSON reporter, so the usual comparison tools work.
+    {
+        char date[64];
+        const std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+#ifdef NDEBUG
+        const char* buildType = "release";
+#else
+        const char* buildType = "debug";
+#endif
+
+        std::fprintf(file, "{\n  \"context\": {\n");
+        std::fprintf(file, "    \"date\": \"%s\",\n", date);
+        std::fprintf(file, "    \"executable\": \"%s\",\n", std::regex_replace(executable, std::regex(R"(\\)"), R"(\\)").c_str());
+        std::fprintf(file, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+        std::fprintf(file, "    \"library_build_type\": \"%s\"\n  },\n", buildType);
+        std::fprintf(file, "  \"benchmarks\": [\n");
+
+        for (size_t i = 0; i < runs.size(); i++)
+        {
+            const Run& run = runs[i];
+
+            std::fprintf(file, "    {\n");
+            std::fprintf(file, "      \"name\": \"%s\",\n", run.name.c_str());
+            std::fprintf(file, "      \"run_name\": \"%s\",\n", run.name.c_str());
+            std::fprintf(file, "      \"run_type\": \"iteration\",\n");
+            std::fprintf(file, "      \"iterations\": %lld,\n", run.iterations);
+            std::fprintf(file, "      \"real_time\": %.6e,\n", run.realNanoseconds);
+            std::fprintf(file, "      \"cpu_time\": %.6e,\n", run.cpuNanoseconds);
+            if (run.itemsPerSecond > 0.0) std::fprintf(file, "      \"items_per_second\": %.6e,\n", run.itemsPerSecond);
+            std::fprintf(file, "      \"time_unit\": \"ns\"\n");
+            std::fprintf(file, "    }%s\n", i + 1 < runs.size() ? "," : "");
+        }
+
+        std::fprintf(file, "  ]\n}\n");
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string argument = argv[i];
+            const size_t equals = argument.find('=');
+            const std::string key = argument.substr(0, equals);
+            const std::string value = equals == std::string::npos ? "" : argument.substr(equals + 1);
+
+            if (key == "--benchmark_filter") options.filter = value;
+            else if (key == "--benchmark_format") options.format = value;
+            else if (key == "--benchmark_out") options.outputPath = value;
+            else if (key == "--benchmark_min_time") options.minTime = std::stod(value);
+            else
+            {
+                std::fprintf(stderr,
+                    "Usage: %s [--benchmark_filter=<regex>] [--benchmark_format=console|json]\n"
+                    "          [--benchmark_out=<file.json>] [--benchmark_min_time=<seconds>]\n", argv[0]);
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+
+State::State(const std::vector<long long>& ranges, const long long iterations)
+    : m_ranges(ranges), m_iterations(iterations)
+{
+}
+
+State::Iterator State::begin()
+{
+    ResumeTiming();
+    return Iterator{ this, m_iterations };
+}
+
+State::Iterator State::end()
+{
+    return Iterator{ this, 0 };
+}
+
+long long State::range(const int index) const
+{
+    return m_ranges.at(index);
+}
+
+long long State::iterations() const
+{
+    return m_iterations;
+}
+
+void State::PauseTiming()
+{
+    if (!m_isRunning) return;
+
+    m_elapsed += Clock::now() - m_start;
+    m_isRunning = false;
+}
+
+void State::ResumeTiming()
+{
+    if (m_isRunning) return;
+
+    m_start = Clock::now();
+    m_isRunning = true;
+}
+
+void State::SetItemsProcessed(const long long items)
+{
+    m_itemsProcessed = items;
+}
+
+long long State::GetItemsProcessed() const
+{
+    return m_itemsProcessed;
+}
+
+double State::GetElapsedSeconds() const
+{
+    return std::chrono::duration<double>(m_elapsed).count();
+}
+
+
+Benchmark::Benchmark(const char* name, const Function function)
+    : m_name(name), m_function(function)
+{
+}
+
+Benchmark* Benchmark::Arg(const long long argument)
+{
+    m_argumentSets.push_back({ argument });
+    return this;
+}
+
+Benchmark* Benchmark::Args(std::initializer_list<long long> arguments)
+{
+    m_argumentSets.emplace_back(arguments);
+    return this;
+}
+
+const std::string& Benchmark::GetName() const
+{
+    return m_name;
+}
+
+Function Benchmark::GetFunction() const
+{
+    return m_function;
+}
+
+const std::vector<std::vector<long long>>& Benchmark::GetArgumentSets() const
+{
+    return m_argumentSets;
+}
+
+
+Benchmark* Bench::RegisterBenchmark(const char* name, const Function function)
+{
+    GetRegistry().push_back(std::make_unique<Benchmark>(name, function));
+    return GetRegistry().back().get();
+}
+
+int Bench::RunSpecifiedBenchmarks(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options)) return 1;
+
+    const std::regex filter(options.filter);
+    const bool isConsole = options.format != "json";
+    std::vector<Run> runs;
+
+    if (isConsole) std::printf("%-40s %18s %18s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+
+    for (const std::unique_ptr<Benchmark>& benchmark : GetRegistry())
+    {
+        std::vector<std::vector<long long>> argumentSets = benchmark->GetArgumentSets();
+        if (argumentSets.empty()) argumentSets.push_back({});
+
+        for (const std::vector<long long>& arguments : argumentSets)
+        {
+            if (!std::regex_search(GetRunName(*benchmark, arguments), filter)) continue;
+
+            runs.push_back(Measure(*benchmark, arguments, options.minTime));
+            if (isConsole) PrintConsole(runs.back());
+        }
+    }
+
+    if (!isConsole) WriteJson(stdout, argv[0], runs);
+
+    if (!options.outputPath.empty())
+    {
+        std::FILE* file = std::fopen(options.outputPath.c_str(), "w");
+        if (!file)
+        {
+            std::fprintf(stderr, "Could not open %s\n", options.outputPath.c_str());
+            return 1;
+        }
+
+        WriteJson(file, argv[0], runs);
+        std::fclose(file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Minimal harness with the Google Benchmark interface (BENCHMARK, State, range-for
+// timing loop, JSON reporter) so the suite builds without fetching anything.
+namespace Bench
+{
+
+    class State
+    {
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<long long> m_ranges;
+        long long m_iterations;
+        long long m_itemsProcessed = 0;
+
+        Clock::time_point m_start;
+        Clock::duration m_elapsed = Clock::duration::zero();
+        bool m_isRunning = false;
+
+    public:
+        struct Value
+            // Non-trivial so `for (auto _ : state)` does not warn about an unused variable.
+        {
+            ~Value() {}
+        };
+
+        struct Iterator
+        {
+            State* state;
+            long long remaining;
+
+            bool operator!=(const Iterator&)
+            {
+                if (remaining-- > 0) return true;
+
+                state->PauseTiming();
+                return false;
+            }
+
+            void operator++() {}
+            Value operator*() const { return Value{}; }
+        };
+
+    public:
+        State(const std::vector<long long>& ranges, const long long iterations);
+
+        Iterator begin();
+        Iterator end();
+
+        long long range(const int index = 0) const;
+        long long iterations() const;
+
+        void PauseTiming();
+        void ResumeTiming();
+
+        void SetItemsProcessed(const long long items);
+        long long GetItemsProcessed() const;
+        double GetElapsedSeconds() const;
+    };
+
+    using Function = void (*)(State&);
+
+    class Benchmark
+    {
+    private:
+        std::string m_name;
+        Function m_function;
+        std::vector<std::vector<long long>> m_argumentSets;
+
+    public:
+        Benchmark(const char* name, const Function function);
+
+        Benchmark* Arg(const long long argument);
+        Benchmark* Args(std::initializer_list<long long> arguments);
+
+        const std::string& GetName() const;
+        Function GetFunction() const;
+        const std::vector<std::vector<long long>>& GetArgumentSets() const;
+    };
+
+    Benchmark* RegisterBenchmark(const char* name, const Function function);
+    int RunSpecifiedBenchmarks(int argc, char** argv);
+
+    extern const void* volatile doNotOptimizeSink;
+
+    template <typename T>
+    inline void DoNotOptimize(const T& value)
+        // Forces value to be materialised so the work producing it is not optimised away.
+    {
+        doNotOptimizeSink = &value;
+    }
+};
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+#define BENCHMARK(function) \
+    static Bench::Benchmark* BENCHMARK_CONCAT(benchmark_, __LINE__) = Bench::RegisterBenchmark(#function, function)
+#define BENCHMARK_TEMPLATE(function, ...) \
+    static Bench::Benchmark* BENCHMARK_CONCAT(benchmark_, __LINE__) = Bench::RegisterBenchmark(#function "<" #__VA_ARGS__ ">", function<__VA_ARGS__>)
+#define BENCHMARK_MAIN() \
+    int main(int argc, char** argv) { return Bench::RunSpecifiedBenchmarks(argc, argv); }
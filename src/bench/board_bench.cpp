@@ -0,0 +1,186 @@
+#include "benchmark.h"
+#include "engine/adjacency.h"
+#include "engine/board.h"
+#include "engine/fixedboard.h"
+#include "engine/generator.h"
+#include "engine/neighbours.h"
+#include "engine/placement.h"
+using namespace Minesweeper;
+
+namespace
+{
+    constexpr float bombDensity = 0.15f;
+
+    int GetNumberOfBombs(const IntVector2 dimensions)
+    {
+        return static_cast<int>(dimensions.y * dimensions.x * bombDensity);
+    }
+}
+
+
+static void BM_GenerateBoard(Bench::State& state)
+    // Full first-click generation: bomb placement plus adjacency counts.
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    Board board(dimensions, GetNumberOfBombs(dimensions));
+    const GenerationOptions options;
+    std::uint64_t seed = 0;
+
+    for (auto _ : state)
+    {
+        GenerateBoard(board, IntVector2{ dimensions.x / 2, dimensions.y / 2 }, options, seed++);
+        Bench::DoNotOptimize(board);
+    }
+
+    state.SetItemsProcessed(state.iterations() * board.GetNumberOfTiles());
+}
+BENCHMARK(BM_GenerateBoard)->Args({ 9, 9 })->Args({ 16, 16 })->Args({ 30, 16 })->Args({ 256, 256 })->Args({ 1024, 1024 })->Args({ 4096, 4096 });
+
+template <int T_Width, int T_Height>
+static void BM_GenerateFixedBoard(Bench::State& state)
+    // BM_GenerateBoard for the classic sizes on a FixedBoard.
+{
+    constexpr IntVector2 dimensions = { T_Width, T_Height };
+    FixedBoard<T_Width, T_Height> board(GetNumberOfBombs(dimensions));
+    std::uint64_t seed = 0;
+
+    for (auto _ : state)
+    {
+        const IntVector2 firstClick = { dimensions.x / 2, dimensions.y / 2 };
+        board.Generate(Xoshiro256StarStar(seed++), GetFirstClickSafeTiles(board, firstClick, FirstClickPolicy::SAFE));
+        Bench::DoNotOptimize(board);
+    }
+
+    state.SetItemsProcessed(state.iterations() * board.GetNumberOfTiles());
+}
+BENCHMARK_TEMPLATE(BM_GenerateFixedBoard, 9, 9);
+BENCHMARK_TEMPLATE(BM_GenerateFixedBoard, 16, 16);
+BENCHMARK_TEMPLATE(BM_GenerateFixedBoard, 30, 16);
+
+static void BM_GenerateInBands(Bench::State& state)
+    // Banded generation of a giant board on range(2) threads (0 for all of them).
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    Board board(dimensions, GetNumberOfBombs(dimensions));
+    std::uint64_t seed = 0;
+
+    for (auto _ : state)
+    {
+        board.GenerateInBands(seed++, {}, (int)state.range(2));
+        Bench::DoNotOptimize(board);
+    }
+
+    state.SetItemsProcessed(state.iterations() * board.GetNumberOfTiles());
+}
+BENCHMARK(BM_GenerateInBands)->Args({ 4096, 4096, 1 })->Args({ 4096, 4096, 0 })->Args({ 20000, 20000, 1 })->Args({ 20000, 20000, 0 });
+
+static void BM_PlayAgain(Bench::State& state)
+    // A new game up to its first click: a fresh Board when range(2) is 0, otherwise the same
+    // one reset in place.
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    const bool isReset = state.range(2) != 0;
+    const GenerationOptions options;
+    Board board(dimensions, GetNumberOfBombs(dimensions));
+    std::uint64_t seed = 0;
+
+    for (auto _ : state)
+    {
+        if (isReset) board.Reset(dimensions, GetNumberOfBombs(dimensions));
+        else board = Board(dimensions, GetNumberOfBombs(dimensions));
+
+        GenerateBoard(board, IntVector2{ dimensions.x / 2, dimensions.y / 2 }, options, seed++);
+        Bench::DoNotOptimize(board);
+    }
+
+    state.SetItemsProcessed(state.iterations() * board.GetNumberOfTiles());
+}
+BENCHMARK(BM_PlayAgain)->Args({ 30, 16, 0 })->Args({ 30, 16, 1 })->Args({ 1024, 1024, 0 })->Args({ 1024, 1024, 1 });
+
+static void BM_PlaceBombs(Bench::State& state)
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    BitPlane bombs;
+    Xoshiro256StarStar random(0);
+
+    for (auto _ : state)
+    {
+        bombs.Assign((size_t)dimensions.x * dimensions.y, false);
+        PlaceBombs(bombs, GetNumberOfBombs(dimensions), random);
+        Bench::DoNotOptimize(bombs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * GetNumberOfBombs(dimensions));
+}
+BENCHMARK(BM_PlaceBombs)->Args({ 9, 9 })->Args({ 30, 16 })->Args({ 1024, 1024 })->Args({ 4096, 4096 });
+
+static void BM_CountAdjacentBombs(Bench::State& state)
+    // Adjacency counts alone, with the scalar kernel when range(2) is 0, otherwise AVX2 (or
+    // scalar again on a CPU without it).
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    const SimdLevel level = state.range(2) == 0 ? SimdLevel::SCALAR : SimdLevel::AVX2;
+    BitPlane bombs;
+    BitPlane emptyTiles;
+    std::vector<std::uint8_t> counts((size_t)dimensions.x * dimensions.y);
+    AdjacencyCounter counter;
+    Xoshiro256StarStar random(0);
+
+    bombs.Assign(counts.size(), false);
+    PlaceBombs(bombs, GetNumberOfBombs(dimensions), random);
+
+    for (auto _ : state)
+    {
+        counter.Count(bombs, dimensions, counts.data(), emptyTiles, level);
+        Bench::DoNotOptimize(counts);
+    }
+
+    state.SetItemsProcessed(state.iterations() * (long long)counts.size());
+}
+BENCHMARK(BM_CountAdjacentBombs)->Args({ 30, 16, 0 })->Args({ 30, 16, 1 })->Args({ 1024, 1024, 0 })->Args({ 1024, 1024, 1 })->Args({ 4096, 4096, 0 })->Args({ 4096, 4096, 1 });
+
+static void BM_FloodFill(Bench::State& state)
+    // Reveal of the first click's region; range(2) is the bomb density in percent, so 0
+    // floods the whole board.
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    const int numberOfBombs = static_cast<int>(dimensions.y * dimensions.x * state.range(2) / 100);
+    Board board(dimensions, numberOfBombs);
+    GenerationOptions options;
+    options.firstClickPolicy = FirstClickPolicy::OPENING;
+    long long numberOfRevealedTiles = 0;
+    std::uint64_t seed = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        GenerateBoard(board, IntVector2{ dimensions.x / 2, dimensions.y / 2 }, options, seed++);
+        state.ResumeTiming();
+
+        board.Reveal(IntVector2{ dimensions.x / 2, dimensions.y / 2 });
+
+        for (const TileSpan& span : board.GetRevealedTiles()) numberOfRevealedTiles += span.endX - span.startX + 1;
+    }
+
+    state.SetItemsProcessed(numberOfRevealedTiles);
+}
+BENCHMARK(BM_FloodFill)->Args({ 30, 16, 15 })->Args({ 256, 256, 10 })->Args({ 1024, 1024, 0 })->Args({ 2048, 2048, 0 });
+
+static void BM_ForEachNeighbourIndex(Bench::State& state)
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(0) };
+    const int numberOfTiles = dimensions.x * dimensions.y;
+    long long sum = 0;
+
+    for (auto _ : state)
+    {
+        for (int index = 0; index < numberOfTiles; index++)
+        {
+            ForEachNeighbourIndex(index, dimensions, [&](const int neighbour) { sum += neighbour; });
+        }
+    }
+
+    Bench::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * numberOfTiles);
+}
+BENCHMARK(BM_ForEachNeighbourIndex)->Arg(9)->Arg(256)->Arg(1024);
@@ -0,0 +1,135 @@
+#include "benchmark.h"
+#include "engine/grid.h"
+#include "engine/random.h"
+#include <vector>
+using namespace Gameboard;
+
+namespace
+{
+    class BenchTile : public Drawable
+        // Drawable with the game's tile geometry that renders nothing.
+    {
+    public:
+        BenchTile()
+            : Drawable(IntVector2{ 40, 40 }, IntVector2{ 10, 10 })
+        {
+        }
+
+        void Render() const override {}
+    };
+
+    class BenchGrid : public Grid<BenchTile>
+    {
+    public:
+        explicit BenchGrid(const int size)
+            : Grid<BenchTile>(IntVector2{ size, size }, BenchTile(), AnchorPoints::MIDDLE, IntVector2{ 400, 300 })
+        {
+        }
+    };
+}
+
+
+static void BM_GetNeighbours(Bench::State& state)
+{
+    const int size = (int)state.range(0);
+    BenchGrid grid(size);
+    BenchTile tile;
+
+    for (auto _ : state)
+    {
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                tile.SetGridCoords(IntVector2{ x, y });
+                Bench::DoNotOptimize(grid.GetNeighbours(tile));
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_GetNeighbours)->Arg(9)->Arg(100);
+
+static void BM_GridForEachNeighbour(Bench::State& state)
+{
+    const int size = (int)state.range(0);
+    BenchGrid grid(size);
+    long long sum = 0;
+
+    for (auto _ : state)
+    {
+        for (int y = 0; y < size; y++)
+        {
+            for (int x = 0; x < size; x++)
+            {
+                grid.ForEachNeighbour(IntVector2{ x, y }, [&](const BenchTile& neighbour) { sum += neighbour.GetGridCoords().x; });
+            }
+        }
+    }
+
+    Bench::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_GridForEachNeighbour)->Arg(9)->Arg(100);
+
+static void BM_HitTest(Bench::State& state)
+    // Screen position to cell lookup used for every mouse click.
+{
+    const int size = (int)state.range(0);
+    const BenchTile sampleTile;
+    GridLayout layout(IntVector2{ size, size }, sampleTile, AnchorPoints::MIDDLE);
+    layout.SetPositionsOnScreen(IntVector2{ 400, 300 });
+
+    // Random positions over the grid's bounding box, margins included.
+    const IntVector2 topLeft = layout.GetCellPositionOnScreen(IntVector2{ 0, 0 });
+    const int extent = size * (sampleTile.GetWidth() + sampleTile.GetMarginWidth());
+    Minesweeper::Xoshiro256StarStar random(0);
+    std::vector<float> positions(2048);
+    for (float& position : positions) position = (float)Minesweeper::UniformBelow(random, (std::uint32_t)extent);
+
+    IntVector2 coords;
+    size_t next = 0;
+    int hits = 0;
+
+    for (auto _ : state)
+    {
+        hits += layout.GetCellAt(topLeft.x + positions[next], topLeft.y + positions[next + 1], coords);
+        next = (next + 2) % positions.size();
+    }
+
+    Bench::DoNotOptimize(hits);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HitTest)->Arg(9)->Arg(30)->Arg(100)->Arg(1000);
+
+static void BM_SetPositionsOnScreen(Bench::State& state)
+    // Grid<T> pushes the position to every entity; GridLayout only moves its origin.
+{
+    const int size = (int)state.range(0);
+    BenchGrid grid(size);
+    int x = 0;
+
+    for (auto _ : state)
+    {
+        grid.SetPositionsOnScreen(IntVector2{ 400 + (x++ & 7), 300 });
+    }
+
+    Bench::DoNotOptimize(grid);
+    state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_SetPositionsOnScreen)->Arg(9)->Arg(100)->Arg(1000);
+
+static void BM_GridLayoutSetPositionsOnScreen(Bench::State& state)
+{
+    const int size = (int)state.range(0);
+    GridLayout layout(IntVector2{ size, size }, BenchTile(), AnchorPoints::MIDDLE);
+    int x = 0;
+
+    for (auto _ : state)
+    {
+        layout.SetPositionsOnScreen(IntVector2{ 400 + (x++ & 7), 300 });
+        Bench::DoNotOptimize(layout);
+    }
+}
+BENCHMARK(BM_GridLayoutSetPositionsOnScreen)->Arg(9)->Arg(1000);
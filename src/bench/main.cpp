@@ -0,0 +1,3 @@
+#include "benchmark.h"
+
+BENCHMARK_MAIN();
@@ -0,0 +1,30 @@
+#include "benchmark.h"
+#include "engine/profiler.h"
+
+#if MINESWEEPER_PROFILE
+
+static void BM_ProfileZone(Bench::State& state)
+    // Cost of one zone: two clock reads and a push into the thread's ring. The ring is drained
+    // between batches, as EndFrame() does once a frame, so no zone is dropped.
+{
+    Minesweeper::Profiler& profiler = Minesweeper::Profiler::Get();
+    long long zonesSinceDrain = 0;
+
+    for (auto _ : state)
+    {
+        PROFILE_ZONE("BM_ProfileZone");
+
+        if (++zonesSinceDrain == (long long)Minesweeper::Profiler::ringCapacity - 1)
+        {
+            state.PauseTiming();
+            profiler.EndFrame();
+            zonesSinceDrain = 0;
+            state.ResumeTiming();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ProfileZone);
+
+#endif
@@ -0,0 +1,106 @@
+#include "benchmark.h"
+#include "engine/actionlog.h"
+#include "engine/board.h"
+#include "engine/generator.h"
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+using namespace Minesweeper;
+
+namespace
+{
+    constexpr float bombDensity = 0.15f;
+
+    std::string GetLogFilePath()
+    {
+        return (std::filesystem::temp_directory_path() / "minesweeper_bench.mslog").string();
+    }
+
+    size_t RecordGame(const IntVector2 dimensions, const std::string& filePath)
+        // A won game: every bomb flagged, unflagged and flagged again, then every safe tile
+        // clicked in random order. Clicks that change nothing are left out, as in the game.
+    {
+        const int numberOfBombs = static_cast<int>(dimensions.y * dimensions.x * bombDensity);
+        const GenerationOptions options = {};
+        const std::uint64_t seed = 0;
+
+        Board board(dimensions, numberOfBombs);
+        std::vector<int> tiles(board.GetNumberOfTiles());
+        std::iota(tiles.begin(), tiles.end(), 0);
+
+        Xoshiro256StarStar random(1);
+        std::shuffle(tiles.begin(), tiles.end(), random);
+
+        ActionLogWriter writer(filePath, ActionLog::CreateHeader(dimensions, numberOfBombs, options, seed));
+        size_t numberOfActions = 0;
+
+        const auto record = [&](const Action& action) {
+            if (!ApplyAction(board, action, options, seed)) return;
+
+            writer.Append(action);
+            numberOfActions++;
+        };
+
+        const int firstClick = board.GetIndex(IntVector2{ dimensions.x / 2, dimensions.y / 2 });
+        record(Action{ 0, firstClick, ActionType::REVEAL });
+
+        for (const int index : tiles)
+        {
+            if (!board.IsBomb(index)) continue;
+
+            record(Action{ 0, index, ActionType::FLAG });
+            record(Action{ 0, index, ActionType::UNFLAG });
+            record(Action{ 0, index, ActionType::FLAG });
+        }
+
+        for (const int index : tiles)
+        {
+            if (!board.IsBomb(index)) record(Action{ 0, index, ActionType::REVEAL });
+        }
+
+        return numberOfActions;
+    }
+}
+
+
+static void BM_ActionLogReplay(Bench::State& state)
+    // Headless replay of a whole recorded game, board generation included.
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    const std::string filePath = GetLogFilePath();
+    const size_t numberOfActions = RecordGame(dimensions, filePath);
+
+    const ActionLogReader log(filePath);
+    Board board(IntVector2{ 1, 1 }, 0);
+
+    for (auto _ : state)
+    {
+        const ReplayResult result = Replay(log, board);
+        Bench::DoNotOptimize(result);
+    }
+
+    std::filesystem::remove(filePath);
+    state.SetItemsProcessed(state.iterations() * (long long)numberOfActions);
+}
+BENCHMARK(BM_ActionLogReplay)->Args({ 30, 16 })->Args({ 1024, 1024 });
+
+static void BM_ActionLogWrite(Bench::State& state)
+    // Streaming records through the writer's buffer to disk.
+{
+    const std::string filePath = GetLogFilePath();
+    const long long numberOfActions = state.range(0);
+
+    for (auto _ : state)
+    {
+        ActionLogWriter writer(filePath, ActionLog::CreateHeader(IntVector2{ 1024, 1024 }, 0, GenerationOptions{}, 0));
+
+        for (long long i = 0; i < numberOfActions; i++)
+        {
+            writer.Append(Action{ (std::uint32_t)i, (int)(i & 0xFFFFF), ActionType::REVEAL });
+        }
+    }
+
+    std::filesystem::remove(filePath);
+    state.SetItemsProcessed(state.iterations() * numberOfActions);
+}
+BENCHMARK(BM_ActionLogWrite)->Arg(1 << 20);
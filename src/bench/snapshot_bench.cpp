@@ -0,0 +1,67 @@
+#include "benchmark.h"
+#include "engine/board.h"
+#include "engine/generator.h"
+#include "engine/snapshot.h"
+#include <filesystem>
+using namespace Minesweeper;
+
+namespace
+{
+    constexpr float bombDensity = 0.15f;
+
+    Board CreateGameInProgress(const IntVector2 dimensions)
+        // A generated board with its opening revealed, so every plane has content.
+    {
+        Board board(dimensions, static_cast<int>(dimensions.y * dimensions.x * bombDensity));
+        const IntVector2 firstClick = { dimensions.x / 2, dimensions.y / 2 };
+
+        GenerateBoard(board, firstClick, GenerationOptions{}, 0);
+        board.Reveal(firstClick);
+
+        return board;
+    }
+
+    std::string GetSnapshotFilePath()
+    {
+        return (std::filesystem::temp_directory_path() / "minesweeper_bench.snapshot").string();
+    }
+}
+
+
+static void BM_SnapshotSave(Bench::State& state)
+    // Whole save to disk: encoding plus the single write and rename.
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    const Board board = CreateGameInProgress(dimensions);
+    const std::string filePath = GetSnapshotFilePath();
+
+    for (auto _ : state)
+    {
+        Snapshot::Save(filePath, board, SnapshotInfo{});
+    }
+
+    std::filesystem::remove(filePath);
+    state.SetItemsProcessed(state.iterations() * dimensions.x * dimensions.y);
+}
+BENCHMARK(BM_SnapshotSave)->Args({ 30, 16 })->Args({ 1024, 1024 })->Args({ 3163, 3163 });
+
+static void BM_SnapshotLoad(Bench::State& state)
+    // Mapping the file, validating it and restoring the board, adjacency counts included.
+{
+    const IntVector2 dimensions = { (int)state.range(0), (int)state.range(1) };
+    const std::string filePath = GetSnapshotFilePath();
+    Snapshot::Save(filePath, CreateGameInProgress(dimensions), SnapshotInfo{});
+
+    Board board(IntVector2{ 1, 1 }, 0);
+    SnapshotInfo info;
+
+    for (auto _ : state)
+    {
+        Snapshot::Load(filePath, board, info);
+        Bench::DoNotOptimize(board);
+    }
+
+    std::filesystem::remove(filePath);
+    state.SetItemsProcessed(state.iterations() * dimensions.x * dimensions.y);
+}
+BENCHMARK(BM_SnapshotLoad)->Args({ 30, 16 })->Args({ 1024, 1024 })->Args({ 3163, 3163 });
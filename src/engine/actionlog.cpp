@@ -0,0 +1,213 @@
+#include "engine/actionlog.h"
+#include "engine/profiler.h"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+using namespace Minesweeper;
+
+// Headers and records are copied as they are in memory.
+static_assert(std::endian::native == std::endian::little, "Action logs are stored little-endian");
+
+
+ActionLogHeader ActionLog::CreateHeader(const IntVector2 dimensions, const int numberOfBombs, const GenerationOptions& options, const std::uint64_t seed)
+{
+    if ((long long)dimensions.x * dimensions.y > maxNumberOfTiles) throw std::invalid_argument("Board is too big to log");
+
+    ActionLogHeader header = {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.headerSize = sizeof(ActionLogHeader);
+    header.width = dimensions.x;
+    header.height = dimensions.y;
+    header.numberOfBombs = numberOfBombs;
+    header.firstClickPolicy = (std::uint8_t)options.firstClickPolicy;
+    header.isNoGuess = options.isNoGuess;
+    header.seed = seed;
+    header.maxAttempts = options.maxAttempts;
+
+    return header;
+}
+
+GenerationOptions ActionLog::GetGenerationOptions(const ActionLogHeader& header)
+    // Generation does not depend on the number of threads, so it is not logged.
+{
+    GenerationOptions options;
+    options.firstClickPolicy = (FirstClickPolicy)header.firstClickPolicy;
+    options.isNoGuess = header.isNoGuess != 0;
+    options.maxAttempts = header.maxAttempts;
+
+    return options;
+}
+
+void ActionLog::Encode(const Action& action, std::byte* destination)
+{
+    const std::uint32_t tileAndType = ((std::uint32_t)action.index << 2) | (std::uint32_t)action.type;
+
+    std::memcpy(destination, &action.milliseconds, sizeof(std::uint32_t));
+    std::memcpy(destination + sizeof(std::uint32_t), &tileAndType, sizeof(std::uint32_t));
+}
+
+Action ActionLog::Decode(const std::byte* source)
+{
+    std::uint32_t tileAndType;
+
+    Action action;
+    std::memcpy(&action.milliseconds, source, sizeof(std::uint32_t));
+    std::memcpy(&tileAndType, source + sizeof(std::uint32_t), sizeof(std::uint32_t));
+
+    action.index = (int)(tileAndType >> 2);
+    action.type = (ActionType)(tileAndType & 3);
+
+    return action;
+}
+
+
+ActionLogWriter::ActionLogWriter(const std::string& filePath, const ActionLogHeader& header, const size_t bufferCapacity)
+    // Throws std::runtime_error if the file cannot be written.
+    : m_filePath(filePath),
+    m_bufferCapacity(bufferCapacity > 0 ? bufferCapacity : 1)
+{
+    m_file = std::fopen(filePath.c_str(), "wb");
+    if (m_file == nullptr) throw std::runtime_error("Cannot write " + filePath);
+
+    m_buffer.resize(sizeof(header));
+    std::memcpy(m_buffer.data(), &header, sizeof(header));
+    m_buffer.reserve(sizeof(header) + m_bufferCapacity * ActionLog::recordSize);
+
+    try
+    {
+        Flush();
+    }
+    catch (...)
+    {
+        std::fclose(m_file);
+        throw;
+    }
+}
+
+ActionLogWriter::~ActionLogWriter()
+{
+    try
+    {
+        Flush();
+    }
+    catch (const std::exception&)
+    {
+        // Nothing to report to from a destructor; the log simply ends early.
+    }
+
+    std::fclose(m_file);
+}
+
+void ActionLogWriter::Append(const Action& action)
+{
+    if (m_buffer.size() >= m_bufferCapacity * ActionLog::recordSize) Flush();
+
+    const size_t offset = m_buffer.size();
+    m_buffer.resize(offset + ActionLog::recordSize);
+    ActionLog::Encode(action, m_buffer.data() + offset);
+}
+
+void ActionLogWriter::Flush()
+    // Hands the buffered records to the OS, so a crash loses at most one buffer of actions.
+{
+    PROFILE_ZONE("ActionLogWriter::Flush");
+
+    if (m_buffer.empty()) return;
+
+    const bool isWritten = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) == m_buffer.size();
+    m_buffer.clear();
+
+    if (!isWritten || std::fflush(m_file) != 0) throw std::runtime_error("Cannot write " + m_filePath);
+}
+
+
+ActionLogReader::ActionLogReader(const std::string& filePath)
+    // Throws std::runtime_error if the file cannot be read and std::invalid_argument if it is
+    // not an action log. A record cut short by a crash at the end of the file is ignored.
+    : m_file(filePath)
+{
+    if (m_file.GetSize() < sizeof(m_header)) throw std::invalid_argument("Action log is truncated");
+    std::memcpy(&m_header, m_file.GetData(), sizeof(m_header));
+
+    if (std::memcmp(m_header.magic, ActionLog::magic, sizeof(ActionLog::magic)) != 0) throw std::invalid_argument("Not an action log");
+    if (m_header.version != ActionLog::version) throw std::invalid_argument("Unsupported action log version " + std::to_string(m_header.version));
+    if (m_header.headerSize < sizeof(ActionLogHeader) || m_header.headerSize > m_file.GetSize()) throw std::invalid_argument("Action log header is invalid");
+
+    if (m_header.width <= 0 || m_header.height <= 0 || (long long)m_header.width * m_header.height > ActionLog::maxNumberOfTiles) {
+        throw std::invalid_argument("Action log has invalid dimensions");
+    }
+
+    if (m_header.numberOfBombs < 0 || m_header.numberOfBombs > m_header.width * m_header.height) {
+        throw std::invalid_argument("Action log has an invalid number of bombs");
+    }
+
+    if (m_header.firstClickPolicy > (std::uint8_t)FirstClickPolicy::OPENING) throw std::invalid_argument("Action log has an unknown first click policy");
+
+    m_records = m_file.GetData() + m_header.headerSize;
+    m_numberOfActions = (m_file.GetSize() - m_header.headerSize) / ActionLog::recordSize;
+}
+
+const ActionLogHeader& ActionLogReader::GetHeader() const
+{
+    return m_header;
+}
+
+size_t ActionLogReader::GetNumberOfActions() const
+{
+    return m_numberOfActions;
+}
+
+Action ActionLogReader::GetAction(const size_t actionIndex) const
+{
+    if (actionIndex >= m_numberOfActions) throw std::out_of_range("Action index out of range");
+
+    const Action action = ActionLog::Decode(m_records + actionIndex * ActionLog::recordSize);
+    if (action.index >= m_header.width * m_header.height) throw std::invalid_argument("Action log holds a tile outside the board");
+
+    return action;
+}
+
+
+bool Minesweeper::ApplyAction(Board& board, const Action& action, const GenerationOptions& options, const std::uint64_t seed)
+    // Applies action the way the game does, generating the board on the first reveal. Only
+    // actions that changed something are logged, so returns false if this one did not.
+{
+    const IntVector2 coords = board.GetCoords(action.index);
+
+    switch (action.type)
+    {
+    case ActionType::REVEAL:
+        if (!board.IsGenerated()) GenerateBoard(board, coords, options, seed);
+        return board.Reveal(action.index) != Board::RevealResult::NOTHING;
+    case ActionType::FLAG:
+        return board.ToggleFlag(coords) == Board::FlagResult::FLAG_ADDED;
+    case ActionType::UNFLAG:
+        return board.ToggleFlag(coords) == Board::FlagResult::FLAG_REMOVED;
+    case ActionType::CHORD:
+        return board.Chord(coords) != Board::RevealResult::NOTHING;
+    default:
+        return false;
+    }
+}
+
+ReplayResult Minesweeper::Replay(const ActionLogReader& log, Board& board)
+    // Resets board to the logged one and plays every action on it, without any timing.
+{
+    const ActionLogHeader& header = log.GetHeader();
+    const GenerationOptions options = ActionLog::GetGenerationOptions(header);
+
+    board.Reset(IntVector2{ header.width, header.height }, header.numberOfBombs);
+
+    ReplayResult result;
+    result.numberOfActions = log.GetNumberOfActions();
+
+    for (size_t i = 0; i < result.numberOfActions; i++)
+    {
+        if (!ApplyAction(board, log.GetAction(i), options, header.seed) && result.firstMismatch < 0) result.firstMismatch = (std::int64_t)i;
+    }
+
+    result.isBombTriggered = board.IsBombTriggered();
+    result.isCleared = board.IsGenerated() && board.IsCleared();
+    return result;
+}
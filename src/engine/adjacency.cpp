@@ -0,0 +1,309 @@
+#include "engine/adjacency.h"
+#include "engine/profiler.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+using namespace Minesweeper;
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define MINESWEEPER_AVX2_KERNEL 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#else
+#define MINESWEEPER_AVX2_KERNEL 0
+#endif
+
+// Counts are spread from bit planes into bytes with whole-word stores.
+static_assert(std::endian::native == std::endian::little, "Count expansion assumes little-endian words");
+
+namespace
+{
+    struct CountPlanes
+        // Bit i of bitN is bit N of the count for tile i.
+    {
+        std::uint64_t bit0;
+        std::uint64_t bit1;
+        std::uint64_t bit2;
+        std::uint64_t bit3;
+    };
+
+    // Byte i of spreadBits[b] is bit i of b.
+    constexpr std::array<std::uint64_t, 256> spreadBits = [] {
+        std::array<std::uint64_t, 256> table = {};
+        for (int bits = 0; bits < 256; bits++)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                if (bits & (1 << i)) table[bits] |= std::uint64_t(1) << (8 * i);
+            }
+        }
+        return table;
+    }();
+
+    void FullAdd(const std::uint64_t a, const std::uint64_t b, const std::uint64_t c, std::uint64_t& sum, std::uint64_t& carry)
+    {
+        const std::uint64_t ab = a ^ b;
+        sum = ab ^ c;
+        carry = (a & b) | (ab & c);
+    }
+
+    CountPlanes SumNeighbours(const std::uint64_t* above, const std::uint64_t* current, const std::uint64_t* below)
+        // Row pointers are at the word being counted; the words either side of it are read
+        // for the bits shifted in from the neighbouring columns.
+    {
+        std::uint64_t sumAbove, carryAbove, sumSides, carrySides, sum, carry;
+
+        FullAdd((above[0] << 1) | (above[-1] >> 63), above[0], (above[0] >> 1) | (above[1] << 63), sumAbove, carryAbove);
+        FullAdd((current[0] << 1) | (current[-1] >> 63), (current[0] >> 1) | (current[1] << 63), (below[0] << 1) | (below[-1] >> 63), sumSides, carrySides);
+
+        const std::uint64_t belowEast = (below[0] >> 1) | (below[1] << 63);
+        const std::uint64_t sumBelow = below[0] ^ belowEast;
+        const std::uint64_t carryBelow = below[0] & belowEast;
+
+        CountPlanes planes;
+        FullAdd(sumAbove, sumSides, sumBelow, planes.bit0, carry);
+
+        // Four carries of weight two.
+        std::uint64_t fours;
+        FullAdd(carryAbove, carrySides, carryBelow, sum, fours);
+        planes.bit1 = sum ^ carry;
+
+        const std::uint64_t moreFours = sum & carry;
+        planes.bit2 = fours ^ moreFours;
+        planes.bit3 = fours & moreFours;
+
+        return planes;
+    }
+
+    void StoreCounts(const CountPlanes& planes, std::uint8_t* counts, const int numberOfTiles)
+        // Writes the counts of the first numberOfTiles (up to 64) tiles of planes.
+    {
+        std::uint8_t bytes[64];
+
+        for (int i = 0; i < 8; i++)
+        {
+            const int shift = 8 * i;
+            const std::uint64_t value = spreadBits[(planes.bit0 >> shift) & 0xFF]
+                | spreadBits[(planes.bit1 >> shift) & 0xFF] << 1
+                | spreadBits[(planes.bit2 >> shift) & 0xFF] << 2
+                | spreadBits[(planes.bit3 >> shift) & 0xFF] << 3;
+
+            std::memcpy(bytes + shift, &value, sizeof(value));
+        }
+
+        std::memcpy(counts, bytes, numberOfTiles);
+    }
+
+#if MINESWEEPER_AVX2_KERNEL
+    AVX2_TARGET __m256i ShiftedWest(const std::uint64_t* row)
+    {
+        const __m256i words = _mm256_loadu_si256((const __m256i*)row);
+        const __m256i previous = _mm256_loadu_si256((const __m256i*)(row - 1));
+        return _mm256_or_si256(_mm256_slli_epi64(words, 1), _mm256_srli_epi64(previous, 63));
+    }
+
+    AVX2_TARGET __m256i ShiftedEast(const std::uint64_t* row)
+    {
+        const __m256i words = _mm256_loadu_si256((const __m256i*)row);
+        const __m256i next = _mm256_loadu_si256((const __m256i*)(row + 1));
+        return _mm256_or_si256(_mm256_srli_epi64(words, 1), _mm256_slli_epi64(next, 63));
+    }
+
+    AVX2_TARGET void FullAdd(const __m256i a, const __m256i b, const __m256i c, __m256i& sum, __m256i& carry)
+    {
+        const __m256i ab = _mm256_xor_si256(a, b);
+        sum = _mm256_xor_si256(ab, c);
+        carry = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(ab, c));
+    }
+
+    AVX2_TARGET __m256i ExpandBits(const std::uint32_t bits)
+        // Byte i is 0xFF if bit i of bits is set, 0 otherwise.
+    {
+        // shuffle_epi8 works within 128-bit lanes, so the upper lane picks bytes 2 and 3 of
+        // its own copy of bits.
+        const __m256i byteSelect = _mm256_setr_epi8(
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+        const __m256i bitSelect = _mm256_set1_epi64x((long long)0x8040201008040201ULL);
+
+        const __m256i spread = _mm256_shuffle_epi8(_mm256_set1_epi32((int)bits), byteSelect);
+        return _mm256_cmpeq_epi8(_mm256_and_si256(spread, bitSelect), bitSelect);
+    }
+
+    AVX2_TARGET void StoreCounts(const std::uint64_t bit0, const std::uint64_t bit1, const std::uint64_t bit2, const std::uint64_t bit3, std::uint8_t* counts)
+        // Writes the counts of 64 tiles.
+    {
+        for (int half = 0; half < 2; half++)
+        {
+            const int shift = 32 * half;
+            __m256i value = _mm256_and_si256(ExpandBits((std::uint32_t)(bit0 >> shift)), _mm256_set1_epi8(1));
+            value = _mm256_or_si256(value, _mm256_and_si256(ExpandBits((std::uint32_t)(bit1 >> shift)), _mm256_set1_epi8(2)));
+            value = _mm256_or_si256(value, _mm256_and_si256(ExpandBits((std::uint32_t)(bit2 >> shift)), _mm256_set1_epi8(4)));
+            value = _mm256_or_si256(value, _mm256_and_si256(ExpandBits((std::uint32_t)(bit3 >> shift)), _mm256_set1_epi8(8)));
+
+            _mm256_storeu_si256((__m256i*)(counts + shift), value);
+        }
+    }
+
+    AVX2_TARGET int CountRowAvx2(const std::uint64_t* above, const std::uint64_t* current, const std::uint64_t* below, const int numberOfWords,
+        std::uint8_t* counts, BitPlane& emptyTiles, const size_t rowStart)
+        // Counts four full words at a time and returns how many words it did.
+    {
+        int word = 0;
+
+        for (; word + 4 <= numberOfWords; word += 4)
+        {
+            const std::uint64_t* const a = above + word;
+            const std::uint64_t* const c = current + word;
+            const std::uint64_t* const b = below + word;
+
+            __m256i sumAbove, carryAbove, sumSides, carrySides, sum, carry, fours;
+
+            const __m256i aboveWords = _mm256_loadu_si256((const __m256i*)a);
+            const __m256i currentWords = _mm256_loadu_si256((const __m256i*)c);
+            const __m256i belowWords = _mm256_loadu_si256((const __m256i*)b);
+
+            FullAdd(ShiftedWest(a), aboveWords, ShiftedEast(a), sumAbove, carryAbove);
+            FullAdd(ShiftedWest(c), ShiftedEast(c), ShiftedWest(b), sumSides, carrySides);
+
+            const __m256i belowEast = ShiftedEast(b);
+            const __m256i sumBelow = _mm256_xor_si256(belowWords, belowEast);
+            const __m256i carryBelow = _mm256_and_si256(belowWords, belowEast);
+
+            __m256i bit0;
+            FullAdd(sumAbove, sumSides, sumBelow, bit0, carry);
+            FullAdd(carryAbove, carrySides, carryBelow, sum, fours);
+
+            const __m256i bit1 = _mm256_xor_si256(sum, carry);
+            const __m256i moreFours = _mm256_and_si256(sum, carry);
+            const __m256i bit2 = _mm256_xor_si256(fours, moreFours);
+            const __m256i bit3 = _mm256_and_si256(fours, moreFours);
+
+            // Empty tiles: no bomb and a count of zero.
+            const __m256i occupied = _mm256_or_si256(_mm256_or_si256(bit0, bit1), _mm256_or_si256(_mm256_or_si256(bit2, bit3), currentWords));
+
+            alignas(32) std::uint64_t planes[5][4];
+            _mm256_store_si256((__m256i*)planes[0], bit0);
+            _mm256_store_si256((__m256i*)planes[1], bit1);
+            _mm256_store_si256((__m256i*)planes[2], bit2);
+            _mm256_store_si256((__m256i*)planes[3], bit3);
+            _mm256_store_si256((__m256i*)planes[4], occupied);
+
+            for (int i = 0; i < 4; i++)
+            {
+                StoreCounts(planes[0][i], planes[1][i], planes[2][i], planes[3][i], counts + 64 * (word + i));
+                emptyTiles.StoreBits(rowStart + 64 * (size_t)(word + i), ~planes[4][i], 64);
+            }
+        }
+
+        return word;
+    }
+#endif
+
+    void LoadRow(const BitPlane& bombs, const size_t rowStart, const int width, std::uint64_t* row)
+        // Copies a row of bombs to row, its bits from bit 0 of row[0] and zero past the end.
+    {
+        const int numberOfWords = (width + 63) / 64;
+
+        for (int word = 0; word < numberOfWords; word++) row[word] = bombs.GetBits(rowStart + 64 * (size_t)word);
+
+        if (width % 64 != 0) row[numberOfWords - 1] &= (std::uint64_t(1) << (width % 64)) - 1;
+    }
+}
+
+
+SimdLevel AdjacencyCounter::GetSupportedSimdLevel()
+{
+    static const SimdLevel level = [] {
+#if MINESWEEPER_AVX2_KERNEL && defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return SimdLevel::SCALAR;
+
+        // AVX2 also needs the OS to save the YMM registers.
+        __cpuid(info, 1);
+        const bool isAvxEnabled = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+        if (!isAvxEnabled) return SimdLevel::SCALAR;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) ? SimdLevel::AVX2 : SimdLevel::SCALAR;
+#elif MINESWEEPER_AVX2_KERNEL
+        return __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SCALAR;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }();
+
+    return level;
+}
+
+void AdjacencyCounter::Count(const BitPlane& bombs, const IntVector2 dimensions, std::uint8_t* counts, BitPlane& emptyTiles, const SimdLevel level)
+    // Writes the number of bombs around every tile to counts (one byte per tile, row-major)
+    // and sets the bits of emptyTiles for tiles with neither a bomb nor one around them.
+    // level is lowered to what the CPU supports.
+{
+    PROFILE_ZONE("AdjacencyCounter::Count");
+
+    const size_t numberOfTiles = (size_t)dimensions.x * dimensions.y;
+    if (emptyTiles.Size() != numberOfTiles) emptyTiles.Assign(numberOfTiles, false);
+
+    CountRows(bombs, dimensions, 0, dimensions.y, counts, emptyTiles, level);
+}
+
+void AdjacencyCounter::CountRows(const BitPlane& bombs, const IntVector2 dimensions, const int startY, const int endY, std::uint8_t* counts, BitPlane& emptyTiles,
+    SimdLevel level)
+    // Count() for rows [startY, endY) only, reading the bombs of the rows either side of them.
+    // emptyTiles must already hold a bit per tile. Calls with different counters whose rows
+    // start and end on multiples of 64 tiles write no shared words and can run concurrently.
+{
+    const int width = dimensions.x;
+    const int height = dimensions.y;
+    const int numberOfWords = (width + 63) / 64;
+    const int fullWords = width / 64;
+    const int stride = numberOfWords + 2;
+
+    if (level == SimdLevel::AVX2 && GetSupportedSimdLevel() != SimdLevel::AVX2) level = SimdLevel::SCALAR;
+
+    // Three rows with a zero guard word either side, rotated as counting moves down.
+    m_rows.assign((size_t)3 * stride, 0);
+    std::uint64_t* above = m_rows.data() + 1;
+    std::uint64_t* current = above + stride;
+    std::uint64_t* below = current + stride;
+
+    if (startY > 0) LoadRow(bombs, (size_t)(startY - 1) * width, width, above);
+    LoadRow(bombs, (size_t)startY * width, width, current);
+
+    for (int y = startY; y < endY; y++)
+    {
+        const size_t rowStart = (size_t)y * width;
+
+        if (y + 1 < height) LoadRow(bombs, rowStart + width, width, below);
+        else std::fill(below, below + numberOfWords, std::uint64_t(0));
+
+        int word = 0;
+
+#if MINESWEEPER_AVX2_KERNEL
+        if (level == SimdLevel::AVX2) word = CountRowAvx2(above, current, below, fullWords, counts + rowStart, emptyTiles, rowStart);
+#endif
+
+        for (; word < numberOfWords; word++)
+        {
+            const int wordWidth = word < fullWords ? 64 : width % 64;
+            const CountPlanes planes = SumNeighbours(above + word, current + word, below + word);
+
+            StoreCounts(planes, counts + rowStart + 64 * word, wordWidth);
+            emptyTiles.StoreBits(rowStart + 64 * (size_t)word, ~(planes.bit0 | planes.bit1 | planes.bit2 | planes.bit3 | current[word]), wordWidth);
+        }
+
+        std::uint64_t* const next = above;
+        above = current;
+        current = below;
+        below = next;
+    }
+}
@@ -0,0 +1,367 @@
+#include "engine/board.h"
+#include "engine/neighbours.h"
+#include "engine/profiler.h"
+#include "engine/threadpool.h"
+#include <algorithm>
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <thread>
+using namespace Minesweeper;
+
+
+Board::Board(const IntVector2 dimensions, const int numberOfBombs)
+{
+    Reset(dimensions, numberOfBombs);
+}
+
+Board::Board(const IntVector2 dimensions, const int numberOfBombs, const std::uint64_t seed)
+    : Board(dimensions, numberOfBombs, Xoshiro256StarStar(seed))
+{
+}
+
+void Board::Reset(const IntVector2 dimensions, const int numberOfBombs)
+    // Starts over with an ungenerated board. Buffers keep their capacity, so resetting to the
+    // same size allocates nothing and a new game costs little more than placing its bombs.
+{
+    if (dimensions.x <= 0 || dimensions.y <= 0) {
+        throw std::invalid_argument("Board dimensions must be positive");
+    }
+
+    if (numberOfBombs < 0 || numberOfBombs > dimensions.x * dimensions.y) {
+        throw std::invalid_argument("Number of bombs must fit on the board");
+    }
+
+    m_dimensions = dimensions;
+    m_numberOfBombs = numberOfBombs;
+    m_adjacentBombs.assign((size_t)dimensions.x * dimensions.y, 0);
+
+    ResetState();
+}
+
+void Board::ResetState()
+{
+    const size_t numberOfTiles = (size_t)m_dimensions.x * m_dimensions.y;
+    m_bombs.Assign(numberOfTiles, false);
+    m_covered.Assign(numberOfTiles, true);
+    m_flagged.Assign(numberOfTiles, false);
+    m_emptyTiles.Assign(numberOfTiles, true);
+
+    ResetCounters();
+}
+
+void Board::ResetCounters()
+{
+    m_numberOfBombsLeft = m_numberOfBombs;
+    m_numberOfFlagsLeft = m_numberOfBombs;
+    m_numberOfCoveredSafeTiles = m_dimensions.x * m_dimensions.y - m_numberOfBombs;
+
+    m_isGenerated = false;
+    m_isBombTriggered = false;
+    m_revealedTiles.clear();
+}
+
+void Board::CountAdjacentBombs()
+{
+    m_adjacencyCounter.Count(m_bombs, m_dimensions, m_adjacentBombs.data(), m_emptyTiles);
+}
+
+void Board::GenerateInBands(const std::uint64_t seed, const std::vector<int>& safeTiles, const int numberOfThreads)
+    // Generate() for giant boards, in bands of generationBandHeight rows on a thread pool
+    // (numberOfThreads as for ThreadPool). How many bombs each band gets is drawn first, from
+    // one stream of seed, so the total stays exact; then every band places its own bombs from
+    // stream DeriveSeed(seed, band), and once all are placed every band counts its own rows.
+    // Bands start on word boundaries of every plane, so they write no shared memory, and the
+    // rows either side of a band are only read after the pool has finished placing: no locks,
+    // and the board only depends on seed, never on the number of threads.
+{
+    PROFILE_ZONE("Board::GenerateInBands");
+
+    if ((size_t)m_numberOfBombs + safeTiles.size() > m_bombs.Size()) {
+        throw std::invalid_argument("Too many safe tiles for the number of bombs");
+    }
+
+    const size_t numberOfTiles = m_bombs.Size();
+    const size_t bandSize = (size_t)generationBandHeight * m_dimensions.x;
+    const int numberOfBands = (m_dimensions.y + generationBandHeight - 1) / generationBandHeight;
+
+    std::vector<std::vector<int>> bandSafeTiles(numberOfBands);
+    for (const int safeTile : safeTiles)
+    {
+        const int band = (int)(safeTile / bandSize);
+        bandSafeTiles[band].push_back(safeTile - (int)(band * bandSize));
+    }
+
+    std::vector<int> bandBombs(numberOfBands);
+    Xoshiro256StarStar random(seed);
+    std::uint32_t candidatesLeft = (std::uint32_t)(numberOfTiles - safeTiles.size());
+    std::uint32_t bombsLeft = m_numberOfBombs;
+
+    for (int band = 0; band < numberOfBands; band++)
+    {
+        const size_t size = std::min(bandSize, numberOfTiles - band * bandSize);
+        const std::uint32_t candidates = (std::uint32_t)(size - bandSafeTiles[band].size());
+
+        bandBombs[band] = (int)SampleHypergeometric(random, candidates, bombsLeft, candidatesLeft);
+        candidatesLeft -= candidates;
+        bombsLeft -= bandBombs[band];
+    }
+
+    const auto placeBand = [&](const int band) {
+        const size_t begin = band * bandSize;
+        const size_t size = std::min(bandSize, numberOfTiles - begin);
+
+        BitPlaneView bombs(m_bombs, begin, size);
+        bombs.Fill(false);
+        BitPlaneView(m_covered, begin, size).Fill(true);
+        BitPlaneView(m_flagged, begin, size).Fill(false);
+
+        Xoshiro256StarStar bandRandom(DeriveSeed(seed, (std::uint64_t)band));
+        PlaceBombs(bombs, bandBombs[band], bandRandom, bandSafeTiles[band]);
+    };
+
+    const auto countBand = [&](const int band, AdjacencyCounter& counter) {
+        const int startY = band * generationBandHeight;
+        counter.CountRows(m_bombs, m_dimensions, startY, std::min(startY + generationBandHeight, m_dimensions.y), m_adjacentBombs.data(), m_emptyTiles);
+    };
+
+    ResetCounters();
+
+    const int threadCount = numberOfThreads > 0 ? numberOfThreads : (int)std::thread::hardware_concurrency();
+    if (threadCount <= 1 || numberOfBands == 1)
+    {
+        for (int band = 0; band < numberOfBands; band++) placeBand(band);
+        for (int band = 0; band < numberOfBands; band++) countBand(band, m_adjacencyCounter);
+    }
+    else
+    {
+        ThreadPool pool(std::min(threadCount, numberOfBands));
+        std::vector<AdjacencyCounter> counters(pool.GetNumberOfThreads());
+
+        // ParallelFor waits for every band, so counting only starts once placing is done.
+        pool.ParallelFor(numberOfBands, [&](const int band, int) { placeBand(band); });
+        pool.ParallelFor(numberOfBands, [&](const int band, const int workerIndex) { countBand(band, counters[workerIndex]); });
+    }
+
+    m_isGenerated = true;
+}
+
+void Board::Uncover(const int index)
+{
+    m_covered.Reset(index);
+    if (!m_bombs.Get(index)) m_numberOfCoveredSafeTiles--;
+
+    const IntVector2 coords = GetCoords(index);
+    m_revealedTiles.push_back(TileSpan{ coords.y, coords.x, coords.x });
+}
+
+Board::RevealResult Board::RevealTile(const int index)
+{
+    if (!m_covered.Get(index) || m_flagged.Get(index)) return RevealResult::NOTHING;
+
+    if (m_bombs.Get(index))
+    {
+        Uncover(index);
+        m_isBombTriggered = true;
+        return RevealResult::EXPLODED;
+    }
+
+    if (m_adjacentBombs[index] == 0) m_numberOfCoveredSafeTiles -= m_floodFill.Reveal(*this, index, m_revealedTiles);
+    else Uncover(index);
+
+    return RevealResult::REVEALED;
+}
+
+bool Board::IsGenerated() const
+{
+    return m_isGenerated;
+}
+
+IntVector2 Board::GetDimensions() const
+{
+    return m_dimensions;
+}
+
+int Board::GetNumberOfTiles() const
+{
+    return m_dimensions.x * m_dimensions.y;
+}
+
+bool Board::IsInsideBoard(const IntVector2 coords) const
+{
+    return coords.x >= 0 && coords.x < m_dimensions.x && coords.y >= 0 && coords.y < m_dimensions.y;
+}
+
+int Board::GetIndex(const IntVector2 coords) const
+{
+    if (!IsInsideBoard(coords)) {
+        throw std::out_of_range("Coordinates are outside the board");
+    }
+
+    return coords.y * m_dimensions.x + coords.x;
+}
+
+IntVector2 Board::GetCoords(const int index) const
+{
+    return IntVector2{ index % m_dimensions.x, index / m_dimensions.x };
+}
+
+ContentOption Board::GetContentOption(const int index) const
+{
+    if (m_bombs.Get(index)) return ContentOption::BOMB;
+    return static_cast<ContentOption>(m_adjacentBombs[index]);
+}
+
+bool Board::IsBomb(const int index) const
+{
+    return m_bombs.Get(index);
+}
+
+bool Board::IsTileCovered(const int index) const
+{
+    return m_covered.Get(index);
+}
+
+bool Board::IsTileFlagged(const int index) const
+{
+    return m_flagged.Get(index);
+}
+
+ContentOption Board::GetContentOption(const IntVector2 coords) const
+{
+    return GetContentOption(GetIndex(coords));
+}
+
+bool Board::IsBomb(const IntVector2 coords) const
+{
+    return IsBomb(GetIndex(coords));
+}
+
+bool Board::IsTileCovered(const IntVector2 coords) const
+{
+    return IsTileCovered(GetIndex(coords));
+}
+
+bool Board::IsTileFlagged(const IntVector2 coords) const
+{
+    return IsTileFlagged(GetIndex(coords));
+}
+
+Board::RevealResult Board::Reveal(const int index)
+{
+    m_revealedTiles.clear();
+    return RevealTile(index);
+}
+
+Board::RevealResult Board::Reveal(const IntVector2 coords)
+{
+    return Reveal(GetIndex(coords));
+}
+
+Board::FlagResult Board::ToggleFlag(const IntVector2 coords)
+{
+    const int index = GetIndex(coords);
+    if (!m_covered.Get(index)) return FlagResult::NOTHING;
+
+    if (m_flagged.Get(index)) // Flag Remove
+    {
+        if (m_bombs.Get(index)) m_numberOfBombsLeft += 1;
+        m_numberOfFlagsLeft += 1;
+        m_flagged.Reset(index);
+
+        return FlagResult::FLAG_REMOVED;
+    }
+
+    // Flag Add
+    if (m_numberOfFlagsLeft <= 0) return FlagResult::NOTHING;
+    if (m_bombs.Get(index)) m_numberOfBombsLeft -= 1;
+    m_numberOfFlagsLeft -= 1;
+    m_flagged.Set(index);
+
+    return FlagResult::FLAG_ADDED;
+}
+
+Board::RevealResult Board::Chord(const IntVector2 coords)
+    // Reveals the covered neighbours of a revealed number once all its flags are placed, in one
+    // batch: numbered tiles and bombs are uncovered directly and the empty ones seed a single
+    // flood fill, so GetRevealedTiles() describes the whole chord.
+{
+    m_revealedTiles.clear();
+
+    const int index = GetIndex(coords);
+    if (m_covered.Get(index) || m_bombs.Get(index)) return RevealResult::NOTHING;
+
+    std::array<int, 8> openNeighbours;
+    int numberOfOpenNeighbours = 0;
+    int numberOfFlagsAround = 0;
+
+    ForEachNeighbourIndex(index, m_dimensions, [&](const int neighbour) {
+        if (m_flagged.Get(neighbour)) numberOfFlagsAround++;
+        else if (m_covered.Get(neighbour)) openNeighbours[numberOfOpenNeighbours++] = neighbour;
+    });
+
+    if (numberOfFlagsAround != m_adjacentBombs[index] || numberOfOpenNeighbours == 0) return RevealResult::NOTHING;
+
+    std::array<int, 8> emptyNeighbours;
+    int numberOfEmptyNeighbours = 0;
+    RevealResult result = RevealResult::REVEALED;
+
+    for (int i = 0; i < numberOfOpenNeighbours; i++)
+    {
+        const int neighbour = openNeighbours[i];
+
+        if (m_bombs.Get(neighbour))
+        {
+            Uncover(neighbour);
+            m_isBombTriggered = true;
+            result = RevealResult::EXPLODED;
+        }
+        else if (m_adjacentBombs[neighbour] == 0) emptyNeighbours[numberOfEmptyNeighbours++] = neighbour;
+        else Uncover(neighbour);
+    }
+
+    if (numberOfEmptyNeighbours > 0) {
+        m_numberOfCoveredSafeTiles -= m_floodFill.Reveal(*this, std::span<const int>(emptyNeighbours.data(), numberOfEmptyNeighbours), m_revealedTiles);
+    }
+
+    return result;
+}
+
+void Board::RevealBombs()
+{
+    m_revealedTiles.clear();
+
+    m_bombs.ForEachSetBit([this](const size_t index) {
+        if (m_covered.Get(index) && !m_flagged.Get(index)) Uncover((int)index);
+    });
+}
+
+const std::vector<TileSpan>& Board::GetRevealedTiles() const
+{
+    return m_revealedTiles;
+}
+
+bool Board::IsBombTriggered() const
+{
+    return m_isBombTriggered;
+}
+
+bool Board::IsCleared() const
+{
+    return m_numberOfCoveredSafeTiles == 0;
+}
+
+int Board::GetNumberOfBombs() const
+{
+    return m_numberOfBombs;
+}
+
+int Board::GetNumberOfFlagsLeft() const
+{
+    return m_numberOfFlagsLeft;
+}
+
+int Board::GetNumberOfBombsLeft() const
+{
+    return m_numberOfBombsLeft;
+}
@@ -0,0 +1,93 @@
+#include "engine/camera.h"
+#include <algorithm>
+using namespace Gameboard;
+
+
+FloatVector2 GridCamera::GetOffset() const
+{
+    return m_offset;
+}
+
+void GridCamera::SetOffset(const FloatVector2 offset)
+{
+    m_offset = offset;
+}
+
+FloatVector2 GridCamera::GetTarget() const
+{
+    return m_target;
+}
+
+void GridCamera::SetTarget(const FloatVector2 target)
+{
+    m_target = target;
+}
+
+float GridCamera::GetZoom() const
+{
+    return m_zoom;
+}
+
+void GridCamera::SetZoom(const float zoom)
+{
+    m_zoom = std::clamp(zoom, m_minZoom, m_maxZoom);
+}
+
+float GridCamera::GetMinZoom() const
+{
+    return m_minZoom;
+}
+
+float GridCamera::GetMaxZoom() const
+{
+    return m_maxZoom;
+}
+
+void GridCamera::SetZoomLimits(const float minZoom, const float maxZoom)
+{
+    m_minZoom = minZoom;
+    m_maxZoom = maxZoom;
+    SetZoom(m_zoom);
+}
+
+void GridCamera::Pan(const FloatVector2 screenDelta)
+    // Moves the view by screenDelta pixels, whatever the zoom.
+{
+    m_target.x -= screenDelta.x / m_zoom;
+    m_target.y -= screenDelta.y / m_zoom;
+}
+
+void GridCamera::ZoomAt(const FloatVector2 screenPosition, const float factor)
+    // Zooms while keeping the world position under screenPosition where it is.
+{
+    const FloatVector2 anchor = ScreenToWorld(screenPosition);
+
+    SetZoom(m_zoom * factor);
+
+    m_offset = screenPosition;
+    m_target = anchor;
+}
+
+void GridCamera::Reset()
+    // Back to the identity transform, where world and screen positions are the same.
+{
+    m_offset = { 0.0f, 0.0f };
+    m_target = { 0.0f, 0.0f };
+    m_zoom = std::clamp(1.0f, m_minZoom, m_maxZoom);
+}
+
+FloatVector2 GridCamera::ScreenToWorld(const FloatVector2 screenPosition) const
+{
+    return FloatVector2{
+        (screenPosition.x - m_offset.x) / m_zoom + m_target.x,
+        (screenPosition.y - m_offset.y) / m_zoom + m_target.y
+    };
+}
+
+FloatVector2 GridCamera::WorldToScreen(const FloatVector2 worldPosition) const
+{
+    return FloatVector2{
+        (worldPosition.x - m_target.x) * m_zoom + m_offset.x,
+        (worldPosition.y - m_target.y) * m_zoom + m_offset.y
+    };
+}
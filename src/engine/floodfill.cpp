@@ -0,0 +1,168 @@
+#include "engine/floodfill.h"
+#include "engine/board.h"
+#include "engine/profiler.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+using namespace Minesweeper;
+
+
+std::uint64_t FloodFill::GetOpenBits(const Board& board, const int index) const
+    // Tiles that may still be uncovered: covered and not flagged.
+{
+    return board.m_covered.GetBits(index) & ~board.m_flagged.GetBits(index);
+}
+
+std::uint64_t FloodFill::GetFloodableBits(const Board& board, const int index) const
+    // Open tiles with no bomb around them.
+{
+    return GetOpenBits(board, index) & board.m_emptyTiles.GetBits(index);
+}
+
+bool FloodFill::IsFloodable(const Board& board, const int index) const
+{
+    return GetFloodableBits(board, index) & 1;
+}
+
+int FloodFill::UncoverRun(Board& board, const int y, const int startX, const int endX, std::vector<TileSpan>& revealedTiles)
+    // Uncovers a flooded run and the tile on either side of it.
+{
+    const int width = board.m_dimensions.x;
+    const int rowStart = y * width;
+    int spanStartX = startX;
+    int spanEndX = endX;
+
+    board.m_covered.ResetRange(rowStart + startX, rowStart + endX + 1);
+
+    if (startX > 0 && (GetOpenBits(board, rowStart + startX - 1) & 1))
+    {
+        board.m_covered.Reset(rowStart + startX - 1);
+        spanStartX--;
+    }
+
+    if (endX < width - 1 && (GetOpenBits(board, rowStart + endX + 1) & 1))
+    {
+        board.m_covered.Reset(rowStart + endX + 1);
+        spanEndX++;
+    }
+
+    revealedTiles.push_back(TileSpan{ y, spanStartX, spanEndX });
+    return spanEndX - spanStartX + 1;
+}
+
+int FloodFill::UncoverNeighbourRow(Board& board, const int y, const int startX, const int endX, std::vector<TileSpan>& revealedTiles)
+    // Uncovers numbered tiles in [startX, endX] on a row next to a flooded run. Empty tiles
+    // are pushed as seeds (one per run) and left covered so they still get flooded later.
+    // Works on 64 tiles at a time: seeds are the first tile of each run of open empty tiles,
+    // spans the runs of open numbered tiles.
+{
+    const int rowStart = y * board.m_dimensions.x;
+    int numberOfUncoveredTiles = 0;
+    int spanStartX = -1;
+    std::uint64_t previousEmpty = 0;
+
+    for (int x = startX; x <= endX; x += 64)
+    {
+        const int length = std::min(endX - x + 1, 64);
+        const std::uint64_t mask = length == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << length) - 1;
+        const int index = rowStart + x;
+
+        const std::uint64_t open = GetOpenBits(board, index) & mask;
+        const std::uint64_t empty = open & board.m_emptyTiles.GetBits(index);
+        const std::uint64_t numbered = open & ~empty;
+
+        for (std::uint64_t seeds = empty & ~((empty << 1) | previousEmpty); seeds != 0; seeds &= seeds - 1)
+        {
+            m_seeds.push_back(index + std::countr_zero(seeds));
+        }
+
+        previousEmpty = (empty >> (length - 1)) & 1;
+
+        board.m_covered.ResetBits(index, numbered);
+        numberOfUncoveredTiles += std::popcount(numbered);
+
+        int bit = 0;
+        while (bit < length)
+        {
+            if (spanStartX < 0)
+            {
+                const std::uint64_t rest = numbered >> bit;
+                if (rest == 0) break;
+
+                bit += std::countr_zero(rest);
+                spanStartX = x + bit;
+            }
+
+            // The span runs on into the next word if it reaches the end of this one.
+            bit += std::countr_one(numbered >> bit);
+            if (bit >= length) break;
+
+            revealedTiles.push_back(TileSpan{ y, spanStartX, x + bit - 1 });
+            spanStartX = -1;
+        }
+    }
+
+    if (spanStartX >= 0) revealedTiles.push_back(TileSpan{ y, spanStartX, endX });
+    return numberOfUncoveredTiles;
+}
+
+int FloodFill::Reveal(Board& board, const int startIndex, std::vector<TileSpan>& revealedTiles)
+{
+    return Reveal(board, std::span<const int>(&startIndex, 1), revealedTiles);
+}
+
+int FloodFill::Reveal(Board& board, const std::span<const int> startIndices, std::vector<TileSpan>& revealedTiles)
+    // All start tiles share one pass, so regions reached from several of them are walked once.
+{
+    PROFILE_ZONE("FloodFill::Reveal");
+
+    const int width = board.m_dimensions.x;
+    const int height = board.m_dimensions.y;
+
+    int numberOfUncoveredTiles = 0;
+    m_seeds.assign(startIndices.begin(), startIndices.end());
+
+    while (!m_seeds.empty())
+    {
+        const int seed = m_seeds.back();
+        m_seeds.pop_back();
+
+        if (!IsFloodable(board, seed)) continue; // Already flooded from another seed.
+
+        const int y = seed / width;
+        const int rowStart = y * width;
+        int startX = seed - rowStart;
+        int endX = startX;
+
+        // Extend the run 64 tiles at a time, right then left.
+        while (endX < width - 1)
+        {
+            const int length = std::min(width - 1 - endX, 64);
+            const std::uint64_t bits = GetFloodableBits(board, rowStart + endX + 1);
+            const int run = std::min(std::countr_one(bits), length);
+
+            endX += run;
+            if (run < length) break;
+        }
+
+        while (startX > 0)
+        {
+            const int length = std::min(startX, 64);
+            const std::uint64_t bits = GetFloodableBits(board, rowStart + startX - length) << (64 - length);
+            const int run = std::countl_one(bits);
+
+            startX -= run;
+            if (run < length) break;
+        }
+
+        // Every tile touching an empty tile is safe, so the run and its border can be uncovered.
+        const int borderStartX = startX > 0 ? startX - 1 : 0;
+        const int borderEndX = endX < width - 1 ? endX + 1 : width - 1;
+
+        numberOfUncoveredTiles += UncoverRun(board, y, startX, endX, revealedTiles);
+        if (y > 0) numberOfUncoveredTiles += UncoverNeighbourRow(board, y - 1, borderStartX, borderEndX, revealedTiles);
+        if (y < height - 1) numberOfUncoveredTiles += UncoverNeighbourRow(board, y + 1, borderStartX, borderEndX, revealedTiles);
+    }
+
+    return numberOfUncoveredTiles;
+}
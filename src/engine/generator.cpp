@@ -0,0 +1,77 @@
+#include "engine/generator.h"
+#include "engine/profiler.h"
+#include "engine/random.h"
+#include "engine/solver.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+using namespace Minesweeper;
+
+namespace
+{
+    void Generate(Board& board, const std::uint64_t seed, const std::vector<int>& safeTiles, const int numberOfThreads)
+        // Which way a board is generated only depends on its size, so a seed always gives the same board.
+    {
+        if (board.GetNumberOfTiles() >= bandedGenerationMinTiles) board.GenerateInBands(seed, safeTiles, numberOfThreads);
+        else board.Generate(Xoshiro256StarStar(seed), safeTiles);
+    }
+}
+
+
+bool Minesweeper::GenerateBoard(Board& board, const IntVector2 firstClick, const GenerationOptions& options, const std::uint64_t seed)
+    // Generates the board around its first click. In no-guess mode attempts are numbered
+    // and spread over worker threads; the lowest numbered attempt the Solver can clear wins,
+    // so the result only depends on the seed, not on the number of threads or scheduling.
+    // Returns false if no-guess mode gave up after maxAttempts (the board is still playable).
+{
+    PROFILE_ZONE("GenerateBoard");
+
+    const std::vector<int> safeTiles = GetFirstClickSafeTiles(board, firstClick, options.firstClickPolicy);
+
+    if (!options.isNoGuess)
+    {
+        Generate(board, seed, safeTiles, options.numberOfThreads);
+        return true;
+    }
+
+    constexpr long long notSolved = std::numeric_limits<long long>::max();
+    std::atomic<long long> nextAttempt = 0;
+    std::atomic<long long> solvedAttempt = notSolved;
+
+    const auto findSolvableAttempt = [&]() {
+        Board candidate(board.GetDimensions(), board.GetNumberOfBombs());
+        Solver solver;
+
+        while (true)
+        {
+            const long long attempt = nextAttempt++;
+            if (attempt >= options.maxAttempts || attempt > solvedAttempt.load()) return;
+
+            // Attempts already run in parallel, so each is generated on its own thread.
+            Generate(candidate, DeriveSeed(seed, attempt), safeTiles, 1);
+            if (candidate.Reveal(firstClick) == Board::RevealResult::EXPLODED) continue;
+            if (!solver.Solve(candidate)) continue;
+
+            long long best = solvedAttempt.load();
+            while (attempt < best && !solvedAttempt.compare_exchange_weak(best, attempt)) {}
+        }
+    };
+
+    const int numberOfThreads = options.numberOfThreads > 0 ? options.numberOfThreads : std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<std::thread> workers;
+
+    for (int i = 1; i < numberOfThreads; i++) workers.emplace_back(findSolvableAttempt);
+    findSolvableAttempt();
+    for (std::thread& worker : workers) worker.join();
+
+    if (solvedAttempt == notSolved)
+    {
+        Generate(board, seed, safeTiles, options.numberOfThreads);
+        return false;
+    }
+
+    Generate(board, DeriveSeed(seed, solvedAttempt), safeTiles, options.numberOfThreads);
+    return true;
+}
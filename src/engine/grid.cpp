@@ -0,0 +1,237 @@
+#include "engine/grid.h"
+#include <algorithm>
+#include <cmath>
+using namespace Gameboard;
+
+
+Drawable::Drawable(const IntVector2 dimensions, const IntVector2 margin)
+    : m_dimensions(dimensions), m_margin(margin)
+{
+}
+
+int Drawable::GetWidth() const
+{
+    return m_dimensions.x;
+}
+
+void Drawable::SetWidth(const int width)
+{
+    m_dimensions.x = width;
+}
+
+int Drawable::GetHeight() const
+{
+    return m_dimensions.y;
+}
+
+void Drawable::SetHeight(const int height)
+{
+    m_dimensions.y = height;
+}
+
+int Drawable::GetMarginWidth() const
+{
+    return m_margin.x;
+}
+
+void Drawable::SetMarginWidth(const int marginWidth)
+{
+    m_margin.x = marginWidth;
+}
+
+int Drawable::GetMarginHeight() const
+{
+    return m_margin.y;
+}
+
+void Drawable::SetMarginHeight(const int marginHeight)
+{
+    m_margin.y = marginHeight;
+}
+
+void Drawable::SetPositionOnScreen(const int x, const int y)
+{
+    m_positionOnScreen = { x, y };
+}
+
+IntVector2 Drawable::GetPositionOnScreen() const
+{
+    return m_positionOnScreen;
+}
+
+void Drawable::SetGridCoords(const IntVector2 coords)
+{
+    m_coords = coords;
+}
+
+IntVector2 Drawable::GetGridCoords() const
+{
+    return m_coords;
+}
+
+
+GridLayout::GridLayout(const IntVector2 dimensions, const Drawable& sampleEntity, const AnchorPoints anchorPoint)
+    : m_anchorPoint(anchorPoint), m_dimensions(dimensions),
+    m_cellDimensions{ sampleEntity.GetWidth(), sampleEntity.GetHeight() },
+    m_cellMargin{ sampleEntity.GetMarginWidth(), sampleEntity.GetMarginHeight() }
+{
+    if (dimensions.x <= 0 || dimensions.y <= 0) {
+        throw std::invalid_argument("Board dimensions must be positive");
+    }
+}
+
+IntVector2 GridLayout::GetBoardPixelDimensions() const
+{
+    IntVector2 dimensions = {};
+
+    dimensions.x = m_dimensions.x * m_cellDimensions.x + (m_dimensions.x - 1) * m_cellMargin.x;
+    dimensions.y = m_dimensions.y * m_cellDimensions.y + (m_dimensions.y - 1) * m_cellMargin.y;
+
+    return dimensions;
+}
+
+IntVector2 GridLayout::GetDimensions() const
+{
+    return m_dimensions;
+}
+
+IntVector2 GridLayout::GetPitch() const
+    // Distance between the origins of neighbouring cells.
+{
+    return IntVector2{ m_cellDimensions.x + m_cellMargin.x, m_cellDimensions.y + m_cellMargin.y };
+}
+
+void GridLayout::SetAnchorPoint(const AnchorPoints anchorPoint)
+{
+    m_anchorPoint = anchorPoint;
+}
+
+IntVector2 GridLayout::GetAnchorOffset() const
+    // Position of the anchor point relative to the grid origin.
+{
+    IntVector2 offset = { 0,0 }; // Default for top left anchor point;
+    IntVector2 pixelDimensions = GetBoardPixelDimensions();
+
+    switch (m_anchorPoint)
+    {
+    case TOP_MIDDLE: offset.x = int(pixelDimensions.x / 2); break;
+    case TOP_RIGHT: offset.x = pixelDimensions.x; break;
+    case MIDDLE_LEFT: offset.y = int(pixelDimensions.y / 2); break;
+
+    case MIDDLE:
+        offset.x = int(pixelDimensions.x / 2);
+        offset.y = int(pixelDimensions.y / 2);
+        break;
+
+    case MIDDLE_RIGHT:
+        offset.x = pixelDimensions.x;
+        offset.y = int(pixelDimensions.y / 2);
+        break;
+
+    case BOTTOM_LEFT:
+        offset.y = pixelDimensions.y;
+        break;
+
+    case BOTTOM_MIDDLE:
+        offset.x = int(pixelDimensions.x / 2);
+        offset.y = pixelDimensions.y;
+        break;
+
+    case BOTTOM_RIGHT:
+        offset.x = pixelDimensions.x;
+        offset.y = pixelDimensions.y;
+        break;
+
+    default:
+        break;
+    }
+
+    return offset;
+}
+
+void GridLayout::SetPositionsOnScreen(const IntVector2 position)
+{
+    const IntVector2 offset = GetAnchorOffset();
+    m_origin = { position.x - offset.x, position.y - offset.y };
+}
+
+void GridLayout::Resize(const IntVector2 dimensions, const Drawable& sampleEntity)
+    // Changes the number and size of the cells, keeping the anchor point where it is on screen.
+{
+    if (dimensions.x <= 0 || dimensions.y <= 0) {
+        throw std::invalid_argument("Board dimensions must be positive");
+    }
+
+    const IntVector2 offset = GetAnchorOffset();
+    const IntVector2 position = { m_origin.x + offset.x, m_origin.y + offset.y };
+
+    m_dimensions = dimensions;
+    m_cellDimensions = { sampleEntity.GetWidth(), sampleEntity.GetHeight() };
+    m_cellMargin = { sampleEntity.GetMarginWidth(), sampleEntity.GetMarginHeight() };
+
+    SetPositionsOnScreen(position);
+}
+
+IntVector2 GridLayout::GetCellPositionOnScreen(const IntVector2 coords) const
+{
+    return IntVector2{
+        m_origin.x + coords.x * (m_cellDimensions.x + m_cellMargin.x),
+        m_origin.y + coords.y * (m_cellDimensions.y + m_cellMargin.y)
+    };
+}
+
+bool GridLayout::GetCellAt(const float x, const float y, IntVector2& coords) const
+    // Finds the cell under the screen position (x, y) directly from the origin and pitch,
+    // so it is cheap enough for per-frame hover queries. Margins between cells belong to no cell.
+{
+    const IntVector2 pitch = GetPitch();
+    if (pitch.x <= 0 || pitch.y <= 0) return false;
+
+    const float localX = x - m_origin.x;
+    const float localY = y - m_origin.y;
+    if (localX < 0 || localY < 0) return false;
+
+    const int cellX = (int)(localX / pitch.x);
+    const int cellY = (int)(localY / pitch.y);
+    if (cellX >= m_dimensions.x || cellY >= m_dimensions.y) return false;
+
+    if (localX - (float)cellX * pitch.x >= m_cellDimensions.x) return false;
+    if (localY - (float)cellY * pitch.y >= m_cellDimensions.y) return false;
+
+    coords = IntVector2{ cellX, cellY };
+    return true;
+}
+
+bool GridLayout::GetCellAt(const GridCamera& camera, const FloatVector2 screenPosition, IntVector2& coords) const
+    // Cell under a screen position when the grid is viewed through camera.
+{
+    const FloatVector2 worldPosition = camera.ScreenToWorld(screenPosition);
+    return GetCellAt(worldPosition.x, worldPosition.y, coords);
+}
+
+bool GridLayout::GetVisibleCells(const GridCamera& camera, const IntVector2 screenDimensions, IntVector2& first, IntVector2& last) const
+    // Range of cells [first, last] overlapping the screen rectangle, computed from its
+    // corners, so culling costs nothing however large the grid is. False if none are visible.
+{
+    const IntVector2 pitch = GetPitch();
+    if (pitch.x <= 0 || pitch.y <= 0) return false;
+
+    const FloatVector2 topLeft = camera.ScreenToWorld(FloatVector2{ 0.0f, 0.0f });
+    const FloatVector2 bottomRight = camera.ScreenToWorld(FloatVector2{ (float)screenDimensions.x, (float)screenDimensions.y });
+
+    // Clamped as floats first so far zoomed out views cannot overflow an int.
+    const auto toCell = [](const float offset, const int pitch, const int size) {
+        return (int)std::clamp(std::floor(offset / pitch), -1.0f, (float)size);
+    };
+
+    first.x = std::max(0, toCell(topLeft.x - m_origin.x, pitch.x, m_dimensions.x));
+    first.y = std::max(0, toCell(topLeft.y - m_origin.y, pitch.y, m_dimensions.y));
+    last.x = std::min(m_dimensions.x - 1, toCell(bottomRight.x - m_origin.x, pitch.x, m_dimensions.x));
+    last.y = std::min(m_dimensions.y - 1, toCell(bottomRight.y - m_origin.y, pitch.y, m_dimensions.y));
+
+    return first.x <= last.x && first.y <= last.y;
+}
+
+void GridLayout::ProcessMouseInput()
+{
+}
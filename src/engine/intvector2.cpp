@@ -0,0 +1,7 @@
+#include "engine/intvector2.h"
+
+
+bool IntVector2::operator==(const IntVector2& other) const
+{
+    return x == other.x && y == other.y;
+}
@@ -0,0 +1,125 @@
+#include "engine/mappedfile.h"
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Minesweeper;
+
+
+MappedFile::MappedFile(const std::string& filePath)
+    // Throws std::runtime_error if the file cannot be opened or mapped. Empty files map to
+    // an empty view.
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Cannot open " + filePath);
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        Close();
+        throw std::runtime_error("Cannot read the size of " + filePath);
+    }
+
+    m_size = (size_t)size.QuadPart;
+    if (m_size == 0) return;
+
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr) m_data = static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    m_file = open(filePath.c_str(), O_RDONLY);
+    if (m_file < 0) throw std::runtime_error("Cannot open " + filePath);
+
+    struct stat status;
+    if (fstat(m_file, &status) != 0)
+    {
+        Close();
+        throw std::runtime_error("Cannot read the size of " + filePath);
+    }
+
+    m_size = (size_t)status.st_size;
+    if (m_size == 0) return;
+
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+    if (data != MAP_FAILED)
+    {
+        m_data = static_cast<const std::byte*>(data);
+        madvise(data, m_size, MADV_SEQUENTIAL);
+    }
+#endif
+
+    if (m_data == nullptr)
+    {
+        Close();
+        throw std::runtime_error("Cannot map " + filePath);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this == &other) return *this;
+
+    Close();
+
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+#if defined(_WIN32)
+    m_file = std::exchange(other.m_file, nullptr);
+    m_mapping = std::exchange(other.m_mapping, nullptr);
+#else
+    m_file = std::exchange(other.m_file, -1);
+#endif
+
+    return *this;
+}
+
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+    if (m_data != nullptr) UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr) CloseHandle(m_mapping);
+    if (m_file != nullptr) CloseHandle(m_file);
+
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data != nullptr) munmap(const_cast<std::byte*>(m_data), m_size);
+    if (m_file >= 0) close(m_file);
+
+    m_file = -1;
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+const std::byte* MappedFile::GetData() const
+{
+    return m_data;
+}
+
+size_t MappedFile::GetSize() const
+{
+    return m_size;
+}
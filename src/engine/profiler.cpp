@@ -0,0 +1,226 @@
+#include "engine/profiler.h"
+
+#if MINESWEEPER_PROFILE
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+using namespace Minesweeper;
+
+namespace
+{
+    std::atomic<long long> numberOfAllocations = 0;
+}
+
+// Counting replacements of the global allocation functions. The nothrow and array forms
+// forward to these by default, so they are counted too.
+void* operator new(const size_t size)
+{
+    numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    void* memory = std::malloc(size > 0 ? size : 1);
+    if (memory == nullptr) throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[](const size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+
+Profiler::Zone::Zone(const char* name)
+    : m_name(name),
+    m_startNanoseconds(Now())
+{
+}
+
+Profiler::Zone::~Zone()
+{
+    Get().Record(ZoneEvent{ m_name, m_startNanoseconds, Now() });
+}
+
+
+Profiler::Profiler()
+    : m_startNanoseconds(Now()),
+    m_lastFrameNanoseconds(m_startNanoseconds)
+{
+    m_frames.reserve(frameHistorySize);
+}
+
+Profiler& Profiler::Get()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+std::int64_t Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long Profiler::GetNumberOfAllocations()
+{
+    return numberOfAllocations.load(std::memory_order_relaxed);
+}
+
+Profiler::ThreadRing& Profiler::GetThreadRing()
+    // Rings are kept until the profiler goes, so a thread that exits leaves its last zones
+    // to be drained.
+{
+    thread_local ThreadRing* threadRing = nullptr;
+    if (threadRing != nullptr) return *threadRing;
+
+    const std::lock_guard<std::mutex> lock(m_ringsMutex);
+
+    m_rings.push_back(std::make_unique<ThreadRing>());
+    m_rings.back()->threadIndex = (int)m_rings.size() - 1;
+    threadRing = m_rings.back().get();
+
+    return *threadRing;
+}
+
+void Profiler::Record(const ZoneEvent& event)
+    // A full ring drops the event rather than wait for the main thread.
+{
+    ThreadRing& ring = GetThreadRing();
+    const std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+
+    if (head - ring.tail.load(std::memory_order_acquire) >= ringCapacity)
+    {
+        m_numberOfDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring.events[head % ringCapacity] = event;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::EndFrame()
+    // Called once per frame, from the main thread only.
+{
+    const std::int64_t now = Now();
+    const long long allocations = GetNumberOfAllocations();
+
+    const FrameStats frame = { (now - m_lastFrameNanoseconds) / 1e6, allocations - m_lastAllocations };
+    if (m_frames.size() < frameHistorySize) m_frames.push_back(frame);
+    else m_frames[m_nextFrame] = frame;
+
+    m_nextFrame = (m_nextFrame + 1) % frameHistorySize;
+    m_lastFrameNanoseconds = now;
+    m_lastAllocations = allocations;
+
+    m_lastFrameZones.clear();
+
+    const std::lock_guard<std::mutex> lock(m_ringsMutex);
+
+    for (const std::unique_ptr<ThreadRing>& ring : m_rings)
+    {
+        const std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+
+        for (std::uint64_t i = tail; i < head; i++)
+        {
+            const ZoneEvent& event = ring->events[i % ringCapacity];
+            const double milliseconds = (event.endNanoseconds - event.startNanoseconds) / 1e6;
+
+            // Names are literals, so equal names almost always share a pointer.
+            auto total = std::find_if(m_lastFrameZones.begin(), m_lastFrameZones.end(), [&](const ZoneTotal& zone) {
+                return zone.name == event.name;
+            });
+
+            if (total == m_lastFrameZones.end()) m_lastFrameZones.push_back(ZoneTotal{ event.name, milliseconds, 1 });
+            else
+            {
+                total->milliseconds += milliseconds;
+                total->count++;
+            }
+
+            if (m_trace.size() < maxTraceEvents) m_trace.push_back(TraceEvent{ event, ring->threadIndex });
+            else m_numberOfDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ring->tail.store(head, std::memory_order_release);
+    }
+
+    std::sort(m_lastFrameZones.begin(), m_lastFrameZones.end(), [](const ZoneTotal& a, const ZoneTotal& b) {
+        return a.milliseconds > b.milliseconds;
+    });
+}
+
+std::vector<Profiler::FrameStats> Profiler::GetFrames() const
+    // Oldest first.
+{
+    std::vector<FrameStats> frames;
+    frames.reserve(m_frames.size());
+
+    for (size_t i = 0; i < m_frames.size(); i++)
+    {
+        frames.push_back(m_frames[(m_nextFrame + i) % m_frames.size()]);
+    }
+
+    return frames;
+}
+
+const std::vector<Profiler::ZoneTotal>& Profiler::GetLastFrameZones() const
+    // Inclusive times, longest first.
+{
+    return m_lastFrameZones;
+}
+
+long long Profiler::GetNumberOfDroppedEvents() const
+{
+    return m_numberOfDroppedEvents.load(std::memory_order_relaxed);
+}
+
+void Profiler::WriteChromeTrace(const std::string& filePath) const
+    // Trace Event Format, opened with chrome://tracing or ui.perfetto.dev. Holds the zones
+    // drained so far, up to maxTraceEvents of them.
+{
+    std::FILE* file = std::fopen(filePath.c_str(), "w");
+    if (file == nullptr) throw std::runtime_error("Cannot write " + filePath);
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (size_t i = 0; i < m_trace.size(); i++)
+    {
+        const TraceEvent& event = m_trace[i];
+
+        std::fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+            event.zone.name,
+            event.threadIndex,
+            (event.zone.startNanoseconds - m_startNanoseconds) / 1e3,
+            (event.zone.endNanoseconds - event.zone.startNanoseconds) / 1e3,
+            i + 1 < m_trace.size() ? "," : "");
+    }
+
+    std::fprintf(file, "]}\n");
+
+    if (std::fclose(file) != 0) throw std::runtime_error("Cannot write " + filePath);
+}
+
+#endif
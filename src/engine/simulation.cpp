@@ -0,0 +1,255 @@
+#include "engine/simulation.h"
+#include "engine/fixedboard.h"
+#include "engine/threadpool.h"
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+using namespace Minesweeper;
+
+namespace
+{
+    // Stream of a game's seed that drives its policy, apart from the streams used for generation.
+    constexpr std::uint64_t policyStream = 0x706F6C696379ull;
+
+    template <typename T_Board>
+    int ChooseRandomTile(const T_Board& board, Xoshiro256StarStar& random)
+    {
+        const int numberOfTiles = board.GetNumberOfTiles();
+
+        // Rejection sampling is almost always enough, the scan only runs late in big games.
+        for (int attempt = 0; attempt < 64; attempt++)
+        {
+            const int index = (int)UniformBelow(random, (std::uint32_t)numberOfTiles);
+            if (board.IsTileCovered(index) && !board.IsTileFlagged(index)) return index;
+        }
+
+        std::vector<int> candidates;
+        for (int index = 0; index < numberOfTiles; index++)
+        {
+            if (board.IsTileCovered(index) && !board.IsTileFlagged(index)) candidates.push_back(index);
+        }
+
+        return candidates[UniformBelow(random, (std::uint32_t)candidates.size())];
+    }
+
+    template <int T_Width, int T_Height>
+    GameResult PlayFixedRandomGame(const SimulationConfig& config, const int gameIndex, const int numberOfBombs)
+        // PlayGame() with the random policy on a generated board, played on a FixedBoard on the
+        // stack. Draws the same random numbers in the same order, so the game is the same.
+    {
+        const std::uint64_t gameSeed = DeriveSeed(config.seed, (std::uint64_t)gameIndex);
+        Xoshiro256StarStar random(DeriveSeed(gameSeed, policyStream));
+
+        FixedBoard<T_Width, T_Height> board(numberOfBombs);
+        GameResult result;
+
+        const IntVector2 firstClick = board.GetCoords((int)UniformBelow(random, (std::uint32_t)board.GetNumberOfTiles()));
+        board.Generate(Xoshiro256StarStar(gameSeed), GetFirstClickSafeTiles(board, firstClick, config.generationOptions.firstClickPolicy));
+
+        board.Reveal(firstClick);
+        result.numberOfClicks++;
+
+        while (!board.IsBombTriggered() && !board.IsCleared())
+        {
+            board.Reveal(ChooseRandomTile(board, random));
+            result.numberOfClicks++;
+        }
+
+        result.isWon = !board.IsBombTriggered();
+        return result;
+    }
+
+    using FixedGamePlayer = GameResult(*)(const SimulationConfig&, const int, const int);
+
+    FixedGamePlayer GetFixedGamePlayer(const SimulationConfig& config)
+        // The classic sizes are played on compile time sized boards when nothing in the game
+        // needs a Board: the Solver, corpus snapshots and no-guess generation all do.
+    {
+        if (config.policy != PolicyType::RANDOM || config.corpus != nullptr || config.isCorpusRecorded || config.generationOptions.isNoGuess) return nullptr;
+
+        if (config.dimensions == IntVector2{ 9, 9 }) return &PlayFixedRandomGame<9, 9>;
+        if (config.dimensions == IntVector2{ 16, 16 }) return &PlayFixedRandomGame<16, 16>;
+        if (config.dimensions == IntVector2{ 30, 16 }) return &PlayFixedRandomGame<30, 16>;
+
+        return nullptr;
+    }
+}
+
+
+int RandomPolicy::ChooseTile(const Board& board, Xoshiro256StarStar& random)
+{
+    return ChooseRandomTile(board, random);
+}
+
+
+void SolverPolicy::StartGame(const Board& board)
+{
+    m_solver.Reset(board);
+}
+
+int SolverPolicy::ChooseTile(const Board& board, Xoshiro256StarStar& random)
+{
+    if (!m_solver.GetSafeTiles().empty()) return m_solver.GetSafeTiles().back();
+
+    // Guess: one of the least likely tiles, ties broken at random.
+    std::vector<int> candidates;
+    float lowestProbability = 2.0f;
+
+    for (int index = 0; index < board.GetNumberOfTiles(); index++)
+    {
+        if (!board.IsTileCovered(index) || m_solver.IsKnownBomb(index)) continue;
+
+        const float probability = m_solver.GetBombProbability(board, index);
+        if (probability > lowestProbability) continue;
+
+        if (probability < lowestProbability)
+        {
+            lowestProbability = probability;
+            candidates.clear();
+        }
+
+        candidates.push_back(index);
+    }
+
+    return candidates[UniformBelow(random, (std::uint32_t)candidates.size())];
+}
+
+void SolverPolicy::OnReveal(const Board& board)
+{
+    m_solver.Update(board, board.GetRevealedTiles());
+}
+
+
+std::unique_ptr<Policy> Minesweeper::CreatePolicy(const PolicyType type)
+{
+    switch (type)
+    {
+    case PolicyType::RANDOM:
+        return std::make_unique<RandomPolicy>();
+    case PolicyType::SOLVER:
+    default:
+        return std::make_unique<SolverPolicy>();
+    }
+}
+
+
+double SimulationResult::GetWinRate() const
+{
+    return numberOfGames > 0 ? (double)numberOfWins / numberOfGames : 0.0;
+}
+
+double SimulationResult::GetMeanClicks() const
+{
+    return numberOfGames > 0 ? (double)numberOfClicks / numberOfGames : 0.0;
+}
+
+double SimulationResult::GetMeanGameMilliseconds() const
+{
+    return numberOfGames > 0 ? totalGameSeconds * 1000.0 / numberOfGames : 0.0;
+}
+
+double SimulationResult::GetGamesPerSecond() const
+{
+    return wallSeconds > 0.0 ? numberOfGames / wallSeconds : 0.0;
+}
+
+
+GameResult Minesweeper::PlayGame(const SimulationConfig& config, const int gameIndex, Board& board, Policy& policy, std::vector<std::byte>* startingPosition)
+    // Everything random in a game comes from DeriveSeed(config.seed, gameIndex), so a game
+    // plays out the same whichever thread runs it. startingPosition, if given, receives a
+    // snapshot of the board after the first click.
+{
+    const std::uint64_t gameSeed = DeriveSeed(config.seed, (std::uint64_t)gameIndex);
+    Xoshiro256StarStar random(DeriveSeed(gameSeed, policyStream));
+
+    GameResult result;
+
+    if (config.corpus != nullptr)
+    {
+        SnapshotInfo info;
+        config.corpus->Read(gameIndex % config.corpus->GetNumberOfSnapshots(), board, info);
+        policy.StartGame(board);
+    }
+    else
+    {
+        // Generation already runs on a pool thread, so it does not start threads of its own.
+        GenerationOptions generationOptions = config.generationOptions;
+        generationOptions.numberOfThreads = 1;
+
+        const IntVector2 firstClick = board.GetCoords((int)UniformBelow(random, (std::uint32_t)board.GetNumberOfTiles()));
+        GenerateBoard(board, firstClick, generationOptions, gameSeed);
+        policy.StartGame(board);
+
+        board.Reveal(firstClick);
+        result.numberOfClicks++;
+
+        if (!board.IsBombTriggered() && !board.IsCleared()) policy.OnReveal(board);
+    }
+
+    if (startingPosition != nullptr) Snapshot::Write(board, SnapshotInfo{ gameSeed, 0 }, *startingPosition);
+
+    while (!board.IsBombTriggered() && !board.IsCleared())
+    {
+        board.Reveal(policy.ChooseTile(board, random));
+        result.numberOfClicks++;
+
+        if (board.IsBombTriggered() || board.IsCleared()) break;
+
+        policy.OnReveal(board);
+    }
+
+    result.isWon = !board.IsBombTriggered();
+    return result;
+}
+
+SimulationResult Minesweeper::RunSimulation(const SimulationConfig& config)
+    // Per-game results are summed in game order, so the totals do not depend on the
+    // number of threads or on which worker played which game.
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int numberOfBombs = static_cast<int>(config.dimensions.y * config.dimensions.x * config.bombDensity);
+    const Clock::time_point start = Clock::now();
+
+    const FixedGamePlayer playFixedGame = GetFixedGamePlayer(config);
+
+    ThreadPool pool(config.numberOfThreads);
+    std::vector<Board> boards(pool.GetNumberOfThreads(), Board(config.dimensions, numberOfBombs));
+    std::vector<std::unique_ptr<Policy>> policies;
+    for (int i = 0; i < pool.GetNumberOfThreads(); i++) policies.push_back(CreatePolicy(config.policy));
+
+    if (config.corpus != nullptr && config.corpus->GetNumberOfSnapshots() == 0) {
+        throw std::invalid_argument("Corpus holds no snapshots");
+    }
+
+    std::vector<GameResult> games(config.numberOfGames);
+    std::vector<double> gameSeconds(config.numberOfGames);
+    std::vector<std::vector<std::byte>> startingPositions(config.isCorpusRecorded ? config.numberOfGames : 0);
+
+    pool.ParallelFor(config.numberOfGames, [&](const int gameIndex, const int workerIndex) {
+        const Clock::time_point gameStart = Clock::now();
+        std::vector<std::byte>* startingPosition = config.isCorpusRecorded ? &startingPositions[gameIndex] : nullptr;
+
+        if (playFixedGame != nullptr) games[gameIndex] = playFixedGame(config, gameIndex, numberOfBombs);
+        else games[gameIndex] = PlayGame(config, gameIndex, boards[workerIndex], *policies[workerIndex], startingPosition);
+        gameSeconds[gameIndex] = std::chrono::duration<double>(Clock::now() - gameStart).count();
+    });
+
+    SimulationResult result;
+    result.numberOfGames = config.numberOfGames;
+
+    for (int i = 0; i < config.numberOfGames; i++)
+    {
+        result.numberOfWins += games[i].isWon;
+        result.numberOfClicks += games[i].numberOfClicks;
+        result.totalGameSeconds += gameSeconds[i];
+    }
+
+    for (const std::vector<std::byte>& startingPosition : startingPositions)
+    {
+        result.corpus.insert(result.corpus.end(), startingPosition.begin(), startingPosition.end());
+    }
+
+    result.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,228 @@
+#include "engine/snapshot.h"
+#include "engine/profiler.h"
+#include <bit>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+using namespace Minesweeper;
+
+// Planes and header fields are copied as they are in memory.
+static_assert(std::endian::native == std::endian::little, "Snapshots are stored little-endian");
+
+namespace
+{
+    size_t GetPlaneBytes(const IntVector2 dimensions)
+    {
+        return ((size_t)dimensions.x * dimensions.y + 63) / 64 * sizeof(std::uint64_t);
+    }
+
+    void WritePlane(const BitPlane& plane, std::byte* destination)
+    {
+        std::memcpy(destination, plane.Data(), plane.WordCount() * sizeof(std::uint64_t));
+    }
+
+    size_t CountBits(const std::byte* source, const size_t numberOfTiles)
+    {
+        size_t count = 0;
+
+        for (size_t word = 0; word * 64 < numberOfTiles; word++)
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, source + word * sizeof(bits), sizeof(bits));
+
+            if (numberOfTiles - word * 64 < 64) bits &= (std::uint64_t(1) << (numberOfTiles - word * 64)) - 1;
+            count += (size_t)std::popcount(bits);
+        }
+
+        return count;
+    }
+
+    void ReadPlane(const std::byte* source, const size_t numberOfTiles, BitPlane& plane)
+        // Padding bits past the last tile must read as zero, whatever the file holds.
+    {
+        plane.Assign(numberOfTiles, false);
+        std::memcpy(plane.Data(), source, plane.WordCount() * sizeof(std::uint64_t));
+
+        if (numberOfTiles % 64 != 0) plane.Data()[plane.WordCount() - 1] &= (std::uint64_t(1) << (numberOfTiles % 64)) - 1;
+    }
+}
+
+
+size_t Snapshot::GetSize(const IntVector2 dimensions)
+{
+    return sizeof(SnapshotHeader) + 3 * GetPlaneBytes(dimensions);
+}
+
+void Snapshot::Write(const Board& board, const SnapshotInfo& info, std::vector<std::byte>& buffer)
+    // Appends the snapshot to buffer.
+{
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.width = board.m_dimensions.x;
+    header.height = board.m_dimensions.y;
+    header.seed = info.seed;
+    header.elapsedMilliseconds = info.elapsedMilliseconds;
+    header.numberOfBombs = board.m_numberOfBombs;
+    header.numberOfBombsLeft = board.m_numberOfBombsLeft;
+    header.numberOfFlagsLeft = board.m_numberOfFlagsLeft;
+    header.numberOfCoveredSafeTiles = board.m_numberOfCoveredSafeTiles;
+    header.flags = 0;
+    if (board.m_isGenerated) header.flags |= IS_GENERATED;
+    if (board.m_isBombTriggered) header.flags |= IS_BOMB_TRIGGERED;
+
+    const size_t planeBytes = GetPlaneBytes(board.m_dimensions);
+    const size_t start = buffer.size();
+    buffer.resize(start + GetSize(board.m_dimensions));
+
+    std::byte* destination = buffer.data() + start;
+    std::memcpy(destination, &header, sizeof(header));
+    destination += sizeof(header);
+
+    WritePlane(board.m_bombs, destination);
+    WritePlane(board.m_covered, destination + planeBytes);
+    WritePlane(board.m_flagged, destination + 2 * planeBytes);
+}
+
+SnapshotHeader Snapshot::ReadHeader(const std::byte* data, const size_t size)
+    // Returns the header of the snapshot at data without touching its planes.
+    // Throws std::invalid_argument if the header is not one of a valid snapshot.
+{
+    SnapshotHeader header;
+    if (size < sizeof(header)) throw std::invalid_argument("Snapshot is truncated");
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) throw std::invalid_argument("Not a board snapshot");
+    if (header.version != version) throw std::invalid_argument("Unsupported snapshot version " + std::to_string(header.version));
+    if (header.headerSize < sizeof(SnapshotHeader)) throw std::invalid_argument("Snapshot header is too small");
+
+    if (header.width <= 0 || header.height <= 0 || (long long)header.width * header.height > INT_MAX) {
+        throw std::invalid_argument("Snapshot has invalid dimensions");
+    }
+
+    if (header.numberOfBombs < 0 || header.numberOfBombs > header.width * header.height) {
+        throw std::invalid_argument("Snapshot has an invalid number of bombs");
+    }
+
+    return header;
+}
+
+size_t Snapshot::Read(const std::byte* data, const size_t size, Board& board, SnapshotInfo& info)
+    // Restores the snapshot at data into board, resizing it if needed, and returns the number
+    // of bytes it took up. Throws std::invalid_argument if data is not a valid snapshot.
+{
+    const SnapshotHeader header = ReadHeader(data, size);
+
+    const IntVector2 dimensions = { header.width, header.height };
+    const int numberOfTiles = dimensions.x * dimensions.y;
+
+    // Later versions may grow the header, so planes start at headerSize rather than sizeof(header).
+    const size_t planeBytes = GetPlaneBytes(dimensions);
+    const size_t totalSize = header.headerSize + 3 * planeBytes;
+    if (size < totalSize) throw std::invalid_argument("Snapshot is truncated");
+
+    const std::byte* planes = data + header.headerSize;
+
+    if ((header.flags & IS_GENERATED) && CountBits(planes, numberOfTiles) != (size_t)header.numberOfBombs) {
+        throw std::invalid_argument("Snapshot bomb plane does not match its bomb count");
+    }
+
+    // Nothing in board changes until the snapshot is known to be valid.
+    ReadPlane(planes, numberOfTiles, board.m_bombs);
+    ReadPlane(planes + planeBytes, numberOfTiles, board.m_covered);
+    ReadPlane(planes + 2 * planeBytes, numberOfTiles, board.m_flagged);
+
+    board.m_dimensions = dimensions;
+    board.m_adjacentBombs.resize(numberOfTiles);
+    board.m_numberOfBombs = header.numberOfBombs;
+    board.m_numberOfBombsLeft = header.numberOfBombsLeft;
+    board.m_numberOfFlagsLeft = header.numberOfFlagsLeft;
+    board.m_numberOfCoveredSafeTiles = header.numberOfCoveredSafeTiles;
+    board.m_isGenerated = (header.flags & IS_GENERATED) != 0;
+    board.m_isBombTriggered = (header.flags & IS_BOMB_TRIGGERED) != 0;
+    board.m_revealedTiles.clear();
+    board.CountAdjacentBombs();
+
+    info.seed = header.seed;
+    info.elapsedMilliseconds = header.elapsedMilliseconds;
+
+    return totalSize;
+}
+
+void Snapshot::Save(const std::string& filePath, const Board& board, const SnapshotInfo& info)
+    // One write of the whole snapshot to a temporary file, renamed over filePath once complete
+    // so a crash mid-save never leaves a torn snapshot behind.
+{
+    PROFILE_ZONE("Snapshot::Save");
+
+    std::vector<std::byte> buffer;
+    buffer.reserve(GetSize(board.m_dimensions));
+    Write(board, info, buffer);
+
+    const std::string temporaryFilePath = filePath + ".tmp";
+    std::FILE* file = std::fopen(temporaryFilePath.c_str(), "wb");
+    if (file == nullptr) throw std::runtime_error("Cannot write " + temporaryFilePath);
+
+    const bool isWritten = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    const bool isClosed = std::fclose(file) == 0;
+
+    if (!isWritten || !isClosed)
+    {
+        std::remove(temporaryFilePath.c_str());
+        throw std::runtime_error("Cannot write " + temporaryFilePath);
+    }
+
+    std::filesystem::rename(temporaryFilePath, filePath);
+}
+
+void Snapshot::Load(const std::string& filePath, Board& board, SnapshotInfo& info)
+{
+    PROFILE_ZONE("Snapshot::Load");
+
+    const MappedFile file(filePath);
+    Read(file.GetData(), file.GetSize(), board, info);
+}
+
+SnapshotHeader Snapshot::LoadHeader(const std::string& filePath)
+{
+    const MappedFile file(filePath);
+    return ReadHeader(file.GetData(), file.GetSize());
+}
+
+
+SnapshotCorpus::SnapshotCorpus(const std::string& filePath)
+    : m_file(filePath)
+{
+    const std::byte* data = m_file.GetData();
+    const size_t size = m_file.GetSize();
+
+    for (size_t offset = 0; offset < size;)
+    {
+        SnapshotHeader header;
+        if (size - offset < sizeof(header)) throw std::invalid_argument("Corpus ends with a truncated snapshot");
+        std::memcpy(&header, data + offset, sizeof(header));
+
+        if (std::memcmp(header.magic, Snapshot::magic, sizeof(Snapshot::magic)) != 0) throw std::invalid_argument("Corpus holds something that is not a snapshot");
+        if (header.headerSize < sizeof(header) || header.width <= 0 || header.height <= 0) throw std::invalid_argument("Corpus holds an invalid snapshot header");
+
+        const size_t snapshotSize = header.headerSize + 3 * GetPlaneBytes(IntVector2{ header.width, header.height });
+        if (snapshotSize > size - offset) throw std::invalid_argument("Corpus ends with a truncated snapshot");
+
+        m_offsets.push_back(offset);
+        offset += snapshotSize;
+    }
+}
+
+int SnapshotCorpus::GetNumberOfSnapshots() const
+{
+    return (int)m_offsets.size();
+}
+
+void SnapshotCorpus::Read(const int snapshotIndex, Board& board, SnapshotInfo& info) const
+{
+    const size_t offset = m_offsets.at(snapshotIndex);
+    Snapshot::Read(m_file.GetData() + offset, m_file.GetSize() - offset, board, info);
+}
@@ -0,0 +1,629 @@
+#include "engine/solver.h"
+#include "engine/neighbours.h"
+#include "engine/profiler.h"
+#include <algorithm>
+#include <array>
+using namespace Minesweeper;
+
+namespace
+{
+    constexpr int maxEnumeratedTiles = 48;
+    constexpr long long maxEnumerationSteps = 1 << 18;
+
+    struct Enumerator
+        // Backtracking over the tiles of one component in discovery order. Each tile only
+        // touches a few constraints, so partial assignments are pruned as soon as one of
+        // them can no longer be met.
+    {
+        int numberOfTiles;
+        std::vector<std::array<int, 8>> constraintsOfTile;
+        std::vector<int> numberOfConstraintsOfTile;
+        std::vector<int> targets;
+        std::vector<int> assignedBombs;
+        std::vector<int> unassignedTiles;
+        std::vector<char> assignment;
+        std::vector<double>& solutions;
+        std::vector<double>& tileBombSolutions;
+        long long steps = 0;
+
+        Enumerator(const int numberOfTiles, std::vector<double>& solutions, std::vector<double>& tileBombSolutions)
+            : numberOfTiles(numberOfTiles),
+            constraintsOfTile(numberOfTiles),
+            numberOfConstraintsOfTile(numberOfTiles, 0),
+            assignment(numberOfTiles, 0),
+            solutions(solutions),
+            tileBombSolutions(tileBombSolutions)
+        {
+        }
+
+        bool Assign(const int tile, const int value)
+        {
+            bool isConsistent = true;
+
+            for (int i = 0; i < numberOfConstraintsOfTile[tile]; i++)
+            {
+                const int constraint = constraintsOfTile[tile][i];
+                assignedBombs[constraint] += value;
+                unassignedTiles[constraint]--;
+
+                if (assignedBombs[constraint] > targets[constraint] ||
+                    assignedBombs[constraint] + unassignedTiles[constraint] < targets[constraint]) isConsistent = false;
+            }
+
+            return isConsistent;
+        }
+
+        void Unassign(const int tile, const int value)
+        {
+            for (int i = 0; i < numberOfConstraintsOfTile[tile]; i++)
+            {
+                const int constraint = constraintsOfTile[tile][i];
+                assignedBombs[constraint] -= value;
+                unassignedTiles[constraint]++;
+            }
+        }
+
+        bool Run(const int tile, const int numberOfBombs)
+            // Returns false when the step budget runs out.
+        {
+            if (++steps > maxEnumerationSteps) return false;
+
+            if (tile == numberOfTiles)
+            {
+                solutions[numberOfBombs] += 1.0;
+                double* const row = tileBombSolutions.data() + (size_t)numberOfBombs * numberOfTiles;
+                for (int i = 0; i < numberOfTiles; i++) row[i] += assignment[i];
+                return true;
+            }
+
+            for (int value = 0; value <= 1; value++)
+            {
+                const bool isConsistent = Assign(tile, value);
+                assignment[tile] = (char)value;
+
+                const bool isWithinBudget = !isConsistent || Run(tile + 1, numberOfBombs + value);
+                Unassign(tile, value);
+
+                if (!isWithinBudget) return false;
+            }
+
+            assignment[tile] = 0;
+            return true;
+        }
+    };
+}
+
+
+bool Solver::IsConstraintTile(const Board& board, const int index) const
+{
+    return !board.IsTileCovered(index) && !board.IsBomb(index);
+}
+
+bool Solver::IsUnknown(const Board& board, const int index) const
+{
+    return board.IsTileCovered(index) && !m_knownBombs.Get(index) && !m_knownSafe.Get(index);
+}
+
+Solver::Constraint Solver::GetConstraint(const Board& board, const int index) const
+    // The number on index minus the bombs already known or uncovered around it, over the
+    // unknown tiles.
+{
+    Constraint constraint = {};
+    constraint.numberOfBombs = static_cast<int>(board.GetContentOption(index));
+
+    ForEachNeighbourIndex(index, board.GetDimensions(), [&](const int neighbour) {
+        if (!board.IsTileCovered(neighbour))
+        {
+            if (board.IsBomb(neighbour)) constraint.numberOfBombs--;
+            return;
+        }
+
+        if (m_knownSafe.Get(neighbour)) return;
+
+        if (m_knownBombs.Get(neighbour)) constraint.numberOfBombs--;
+        else constraint.tiles[constraint.numberOfTiles++] = neighbour;
+    });
+
+    std::sort(constraint.tiles, constraint.tiles + constraint.numberOfTiles);
+    return constraint;
+}
+
+void Solver::Enqueue(const int index)
+{
+    if (m_queued.Get(index)) return;
+
+    m_queued.Set(index);
+    m_queue.push_back(index);
+}
+
+void Solver::EnqueueConstraintsAround(const Board& board, const int index)
+{
+    ForEachNeighbourIndex(index, board.GetDimensions(), [&](const int neighbour) {
+        if (IsConstraintTile(board, neighbour)) Enqueue(neighbour);
+    });
+}
+
+void Solver::InvalidateComponent(const int index)
+    // Drops the component holding index; its tiles are regrouped by RebuildComponents().
+{
+    const auto found = m_componentOfTile.find(index);
+    if (found == m_componentOfTile.end()) return;
+
+    const int id = found->second.component;
+    Component& component = m_components[id];
+
+    for (const int tile : component.tiles)
+    {
+        m_componentOfTile.erase(tile);
+        m_regroupTiles.push_back(tile);
+    }
+
+    component.isAlive = false;
+    component.tiles.clear();
+    m_freeComponents.push_back(id);
+}
+
+void Solver::MarkSafe(const Board& board, const int index)
+{
+    if (!IsUnknown(board, index)) return;
+
+    m_knownSafe.Set(index);
+    m_safeTiles.push_back(index);
+    m_numberOfUnknownTiles--;
+
+    InvalidateComponent(index);
+    EnqueueConstraintsAround(board, index);
+}
+
+void Solver::MarkBomb(const Board& board, const int index)
+{
+    if (!IsUnknown(board, index)) return;
+
+    m_knownBombs.Set(index);
+    m_numberOfKnownBombs++;
+    m_remainingBombs--;
+    m_numberOfUnknownTiles--;
+
+    InvalidateComponent(index);
+    EnqueueConstraintsAround(board, index);
+}
+
+void Solver::ApplyConstraint(const Board& board, const Constraint& constraint)
+{
+    if (constraint.numberOfBombs == 0)
+    {
+        for (int i = 0; i < constraint.numberOfTiles; i++) MarkSafe(board, constraint.tiles[i]);
+    }
+    else if (constraint.numberOfBombs == constraint.numberOfTiles)
+    {
+        for (int i = 0; i < constraint.numberOfTiles; i++) MarkBomb(board, constraint.tiles[i]);
+    }
+}
+
+void Solver::ApplySubsetRule(const Board& board, const Constraint& subset, const Constraint& superset)
+    // If every tile of subset is also in superset, the tiles only in superset hold
+    // exactly the difference in bombs.
+{
+    if (subset.numberOfTiles >= superset.numberOfTiles) return;
+    if (!std::includes(superset.tiles, superset.tiles + superset.numberOfTiles, subset.tiles, subset.tiles + subset.numberOfTiles)) return;
+
+    Constraint difference = {};
+    difference.numberOfBombs = superset.numberOfBombs - subset.numberOfBombs;
+    difference.numberOfTiles = (int)(std::set_difference(
+        superset.tiles, superset.tiles + superset.numberOfTiles,
+        subset.tiles, subset.tiles + subset.numberOfTiles,
+        difference.tiles) - difference.tiles);
+
+    ApplyConstraint(board, difference);
+}
+
+void Solver::Propagate(const Board& board)
+    // Works through the queued constraints, single rule first and the subset rule only
+    // when that finds nothing. Every new safe tile or bomb queues the constraints around it.
+{
+    const IntVector2 dimensions = board.GetDimensions();
+
+    for (size_t i = 0; i < m_queue.size(); i++)
+    {
+        const int index = m_queue[i];
+        m_queued.Reset(index);
+
+        // The unknown tiles around index may now group differently.
+        ForEachNeighbourIndex(index, dimensions, [&](const int neighbour) {
+            if (m_componentOfTile.count(neighbour)) InvalidateComponent(neighbour);
+            else if (IsUnknown(board, neighbour)) m_regroupTiles.push_back(neighbour);
+        });
+
+        const Constraint constraint = GetConstraint(board, index);
+        if (constraint.numberOfTiles == 0) continue;
+
+        if (constraint.numberOfBombs == 0 || constraint.numberOfBombs == constraint.numberOfTiles)
+        {
+            ApplyConstraint(board, constraint);
+            continue;
+        }
+
+        // Constraints sharing a tile have centres at most two tiles apart.
+        const IntVector2 coords = board.GetCoords(index);
+
+        for (int y = std::max(coords.y - 2, 0); y <= std::min(coords.y + 2, dimensions.y - 1); y++)
+        {
+            for (int x = std::max(coords.x - 2, 0); x <= std::min(coords.x + 2, dimensions.x - 1); x++)
+            {
+                const int other = y * dimensions.x + x;
+                if (other == index || !IsConstraintTile(board, other)) continue;
+
+                const Constraint otherConstraint = GetConstraint(board, other);
+                if (otherConstraint.numberOfTiles == 0) continue;
+
+                ApplySubsetRule(board, constraint, otherConstraint);
+                ApplySubsetRule(board, otherConstraint, constraint);
+            }
+        }
+    }
+
+    m_queue.clear();
+}
+
+void Solver::ApplyBombCountRule(const Board& board)
+    // Once every bomb is known the rest is safe, and once the unknown tiles are all
+    // that is left for the remaining bombs they are all bombs. Both happen at most once a game.
+{
+    if (m_numberOfUnknownTiles == 0) return;
+    if (m_remainingBombs != 0 && m_remainingBombs != m_numberOfUnknownTiles) return;
+
+    const bool areBombs = m_remainingBombs != 0;
+
+    for (int index = 0; index < board.GetNumberOfTiles(); index++)
+    {
+        if (!IsUnknown(board, index)) continue;
+
+        if (areBombs) MarkBomb(board, index);
+        else MarkSafe(board, index);
+    }
+}
+
+void Solver::BuildComponent(const Board& board, const int seedTile)
+    // Collects every unknown tile reachable from seedTile through shared constraints and
+    // counts the bomb layouts that satisfy them.
+{
+    int id;
+    if (m_freeComponents.empty())
+    {
+        id = (int)m_components.size();
+        m_components.emplace_back();
+    }
+    else
+    {
+        id = m_freeComponents.back();
+        m_freeComponents.pop_back();
+    }
+
+    Component& component = m_components[id];
+    m_constraints.clear();
+
+    component.isAlive = true;
+    component.tiles.assign(1, seedTile);
+    m_componentOfTile[seedTile] = ComponentTile{ id, 0 };
+    m_componentConstraints.clear();
+
+    for (size_t i = 0; i < component.tiles.size(); i++)
+    {
+        ForEachNeighbourIndex(component.tiles[i], board.GetDimensions(), [&](const int centre) {
+            if (!IsConstraintTile(board, centre) || !m_componentConstraints.insert(centre).second) return;
+
+            Constraint constraint = GetConstraint(board, centre);
+
+            for (int j = 0; j < constraint.numberOfTiles; j++)
+            {
+                const auto [entry, isNew] = m_componentOfTile.try_emplace(constraint.tiles[j], ComponentTile{ id, (int)component.tiles.size() });
+                if (isNew) component.tiles.push_back(constraint.tiles[j]);
+
+                constraint.tiles[j] = entry->second.localIndex;
+            }
+
+            m_constraints.push_back(constraint);
+        });
+    }
+
+    Enumerate(component, m_constraints);
+}
+
+void Solver::Enumerate(Component& component, const std::vector<Constraint>& constraints)
+{
+    const int numberOfTiles = (int)component.tiles.size();
+
+    component.isEnumerated = false;
+
+    if (numberOfTiles <= maxEnumeratedTiles)
+    {
+        component.solutions.assign((size_t)numberOfTiles + 1, 0.0);
+        component.tileBombSolutions.assign((size_t)(numberOfTiles + 1) * numberOfTiles, 0.0);
+
+        Enumerator enumerator(numberOfTiles, component.solutions, component.tileBombSolutions);
+
+        for (const Constraint& constraint : constraints)
+        {
+            const int id = (int)enumerator.targets.size();
+            enumerator.targets.push_back(constraint.numberOfBombs);
+            enumerator.assignedBombs.push_back(0);
+            enumerator.unassignedTiles.push_back(constraint.numberOfTiles);
+
+            for (int i = 0; i < constraint.numberOfTiles; i++)
+            {
+                const int tile = constraint.tiles[i];
+                enumerator.constraintsOfTile[tile][enumerator.numberOfConstraintsOfTile[tile]++] = id;
+            }
+        }
+
+        component.isEnumerated = enumerator.Run(0, 0);
+        if (component.isEnumerated) return;
+    }
+
+    // Too big to enumerate: fall back to the most pessimistic single-constraint estimate.
+    component.localProbabilities.assign(numberOfTiles, 0.0f);
+
+    for (const Constraint& constraint : constraints)
+    {
+        const float probability = (float)constraint.numberOfBombs / constraint.numberOfTiles;
+
+        for (int i = 0; i < constraint.numberOfTiles; i++)
+        {
+            float& tileProbability = component.localProbabilities[constraint.tiles[i]];
+            tileProbability = std::max(tileProbability, probability);
+        }
+    }
+}
+
+void Solver::GetValidBombRange(const Component& component, int& minimumBombs, int& maximumBombs) const
+    // Layouts must leave a bomb count the rest of the unknown tiles can hold.
+{
+    const int numberOfTiles = (int)component.tiles.size();
+
+    minimumBombs = std::max(0, m_remainingBombs - (m_numberOfUnknownTiles - numberOfTiles));
+    maximumBombs = std::min(m_remainingBombs, numberOfTiles);
+}
+
+void Solver::ApplyComponentCertainties(const Board& board, const Component& component)
+    // Tiles that are safe, or a bomb, in every valid layout.
+{
+    if (!component.isEnumerated) return;
+
+    const int numberOfTiles = (int)component.tiles.size();
+    int minimumBombs, maximumBombs;
+    GetValidBombRange(component, minimumBombs, maximumBombs);
+
+    double total = 0.0;
+    for (int k = minimumBombs; k <= maximumBombs; k++) total += component.solutions[k];
+    if (total == 0.0) return;
+
+    std::vector<int> safeTiles, bombTiles;
+
+    for (int i = 0; i < numberOfTiles; i++)
+    {
+        double bombSolutions = 0.0;
+        for (int k = minimumBombs; k <= maximumBombs; k++) bombSolutions += component.tileBombSolutions[(size_t)k * numberOfTiles + i];
+
+        if (bombSolutions == 0.0) safeTiles.push_back(component.tiles[i]);
+        else if (bombSolutions == total) bombTiles.push_back(component.tiles[i]);
+    }
+
+    // Marking invalidates component, so it is not touched past this point.
+    for (const int tile : safeTiles) MarkSafe(board, tile);
+    for (const int tile : bombTiles) MarkBomb(board, tile);
+}
+
+void Solver::RebuildComponents(const Board& board)
+{
+    std::vector<int> builtComponents;
+
+    for (size_t i = 0; i < m_regroupTiles.size(); i++)
+    {
+        const int tile = m_regroupTiles[i];
+        if (!IsUnknown(board, tile) || m_componentOfTile.count(tile)) continue;
+
+        bool isOnFrontier = false;
+        ForEachNeighbourIndex(tile, board.GetDimensions(), [&](const int neighbour) {
+            isOnFrontier |= IsConstraintTile(board, neighbour);
+        });
+
+        if (!isOnFrontier) continue;
+
+        BuildComponent(board, tile);
+        builtComponents.push_back(m_componentOfTile[tile].component);
+    }
+
+    m_regroupTiles.clear();
+
+    for (const int id : builtComponents)
+    {
+        if (m_components[id].isAlive) ApplyComponentCertainties(board, m_components[id]);
+    }
+}
+
+void Solver::UpdateInteriorProbability()
+    // Unknown tiles off the frontier share whatever bombs the frontier is not expected to hold.
+{
+    const double probability = m_numberOfUnknownTiles > 0 ? (double)m_remainingBombs / m_numberOfUnknownTiles : 0.0;
+    const double clamped = std::clamp(probability, 1e-6, 1.0 - 1e-6);
+    m_bombRatio = clamped / (1.0 - clamped);
+
+    double expectedFrontierBombs = 0.0;
+
+    for (const Component& component : m_components)
+    {
+        if (!component.isAlive) continue;
+
+        if (!component.isEnumerated)
+        {
+            for (const float tileProbability : component.localProbabilities) expectedFrontierBombs += tileProbability;
+            continue;
+        }
+
+        int minimumBombs, maximumBombs;
+        GetValidBombRange(component, minimumBombs, maximumBombs);
+
+        double weight = 1.0, total = 0.0, bombs = 0.0;
+        for (int k = minimumBombs; k <= maximumBombs; k++, weight *= m_bombRatio)
+        {
+            total += component.solutions[k] * weight;
+            bombs += component.solutions[k] * weight * k;
+        }
+
+        if (total > 0.0) expectedFrontierBombs += bombs / total;
+    }
+
+    const int numberOfInteriorTiles = m_numberOfUnknownTiles - (int)m_componentOfTile.size();
+    m_interiorProbability = numberOfInteriorTiles > 0
+        ? (float)std::clamp((m_remainingBombs - expectedFrontierBombs) / numberOfInteriorTiles, 0.0, 1.0)
+        : 0.0f;
+}
+
+void Solver::Settle(const Board& board)
+{
+    do
+    {
+        Propagate(board);
+        ApplyBombCountRule(board);
+        RebuildComponents(board);
+    } while (!m_queue.empty());
+
+    UpdateInteriorProbability();
+}
+
+void Solver::Reset(const Board& board)
+    // Full rebuild from the current board, Update() keeps it current from there.
+{
+    PROFILE_ZONE("Solver::Reset");
+
+    const int numberOfTiles = board.GetNumberOfTiles();
+
+    m_knownBombs.Assign(numberOfTiles, false);
+    m_knownSafe.Assign(numberOfTiles, false);
+    m_queued.Assign(numberOfTiles, false);
+    m_numberOfKnownBombs = 0;
+
+    m_queue.clear();
+    m_safeTiles.clear();
+    m_regroupTiles.clear();
+    m_componentOfTile.clear();
+    m_freeComponents.clear();
+
+    for (int id = (int)m_components.size() - 1; id >= 0; id--)
+    {
+        m_components[id].isAlive = false;
+        m_components[id].tiles.clear();
+        m_freeComponents.push_back(id);
+    }
+
+    // A bomb uncovered by a chord over a wrong flag is neither unknown nor remaining.
+    m_numberOfUnknownTiles = 0;
+    m_remainingBombs = board.GetNumberOfBombs();
+    for (int index = 0; index < numberOfTiles; index++)
+    {
+        if (board.IsTileCovered(index)) m_numberOfUnknownTiles++;
+        else if (board.IsBomb(index)) m_remainingBombs--;
+        else Enqueue(index);
+    }
+
+    Settle(board);
+}
+
+void Solver::Update(const Board& board, const std::vector<TileSpan>& revealedTiles)
+    // Re-evaluates only the constraints around revealedTiles, as returned by
+    // Board::GetRevealedTiles() after a reveal or chord.
+{
+    PROFILE_ZONE("Solver::Update");
+
+    const int width = board.GetDimensions().x;
+
+    for (const TileSpan& span : revealedTiles)
+    {
+        for (int x = span.startX; x <= span.endX; x++)
+        {
+            const int index = span.y * width + x;
+
+            InvalidateComponent(index);
+
+            // Known tiles are already off the unknown count, and known bombs off the remaining ones.
+            if (!m_knownSafe.Get(index) && !m_knownBombs.Get(index))
+            {
+                m_numberOfUnknownTiles--;
+                if (board.IsBomb(index)) m_remainingBombs--;
+            }
+
+            if (IsConstraintTile(board, index)) Enqueue(index);
+            EnqueueConstraintsAround(board, index);
+        }
+    }
+
+    m_safeTiles.erase(std::remove_if(m_safeTiles.begin(), m_safeTiles.end(), [&](const int index) {
+        return !board.IsTileCovered(index);
+    }), m_safeTiles.end());
+
+    Settle(board);
+}
+
+bool Solver::Solve(Board& board)
+    // Keeps revealing deduced safe tiles until the board is cleared or a guess is needed.
+{
+    Reset(board);
+
+    while (!board.IsCleared())
+    {
+        if (m_safeTiles.empty()) return false;
+
+        const int index = m_safeTiles.back();
+        const Board::RevealResult result = board.Reveal(index);
+
+        if (result == Board::RevealResult::EXPLODED) return false;
+        if (result == Board::RevealResult::NOTHING) m_safeTiles.pop_back(); // Flagged.
+        else Update(board, board.GetRevealedTiles());
+    }
+
+    return true;
+}
+
+const std::vector<int>& Solver::GetSafeTiles() const
+    // Certainly safe tiles that are still covered.
+{
+    return m_safeTiles;
+}
+
+bool Solver::IsKnownSafe(const int index) const
+{
+    return m_knownSafe.Get(index);
+}
+
+bool Solver::IsKnownBomb(const int index) const
+{
+    return m_knownBombs.Get(index);
+}
+
+float Solver::GetBombProbability(const Board& board, const int index) const
+    // Layouts with k bombs in a component are weighted by r^k, r = p / (1 - p) for the
+    // density p of the unknown tiles. That is the limit of the exact C(interior, bombs - k)
+    // weighting on large boards and keeps every component independent of the others.
+{
+    if (!board.IsTileCovered(index) || m_knownSafe.Get(index)) return 0.0f;
+    if (m_knownBombs.Get(index)) return 1.0f;
+
+    const auto found = m_componentOfTile.find(index);
+    if (found == m_componentOfTile.end()) return m_interiorProbability;
+
+    const Component& component = m_components[found->second.component];
+    if (!component.isEnumerated) return component.localProbabilities[found->second.localIndex];
+
+    const int numberOfTiles = (int)component.tiles.size();
+    int minimumBombs, maximumBombs;
+    GetValidBombRange(component, minimumBombs, maximumBombs);
+
+    double weight = 1.0, total = 0.0, bombs = 0.0;
+    for (int k = minimumBombs; k <= maximumBombs; k++, weight *= m_bombRatio)
+    {
+        total += component.solutions[k] * weight;
+        bombs += component.tileBombSolutions[(size_t)k * numberOfTiles + found->second.localIndex] * weight;
+    }
+
+    return total > 0.0 ? (float)(bombs / total) : 0.0f;
+}
@@ -0,0 +1,126 @@
+#include "engine/threadpool.h"
+using namespace Minesweeper;
+
+namespace
+{
+    thread_local int currentWorkerIndex = -1;
+}
+
+
+ThreadPool::ThreadPool(const int numberOfThreads)
+{
+    const int count = numberOfThreads > 0 ? numberOfThreads : std::max(1, (int)std::thread::hardware_concurrency());
+
+    for (int i = 0; i < count; i++) m_queues.push_back(std::make_unique<WorkQueue>());
+    for (int i = 0; i < count; i++) m_workers.emplace_back(&ThreadPool::RunWorker, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_isStopping = true;
+    }
+
+    m_workAvailable.notify_all();
+    for (std::thread& worker : m_workers) worker.join();
+}
+
+int ThreadPool::GetNumberOfThreads() const
+{
+    return (int)m_queues.size();
+}
+
+int ThreadPool::GetWorkerIndex()
+    // Index of the calling worker thread, or -1 when not called from a worker.
+{
+    return currentWorkerIndex;
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+    // Tasks submitted from a worker go to its own queue, others are spread round robin.
+{
+    const int queueIndex = currentWorkerIndex >= 0 ? currentWorkerIndex : m_nextQueue++ % GetNumberOfThreads();
+    WorkQueue& queue = *m_queues[queueIndex];
+
+    m_numberOfUnfinishedTasks++;
+
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_numberOfQueuedTasks++;
+    }
+
+    m_workAvailable.notify_one();
+}
+
+bool ThreadPool::TryPop(const int workerIndex, std::function<void()>& task)
+{
+    {
+        WorkQueue& own = *m_queues[workerIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (int offset = 1; offset < GetNumberOfThreads(); offset++)
+    {
+        WorkQueue& victim = *m_queues[(workerIndex + offset) % GetNumberOfThreads()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::RunWorker(const int workerIndex)
+{
+    currentWorkerIndex = workerIndex;
+    std::function<void()> task;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_stateMutex);
+            m_workAvailable.wait(lock, [this]() { return m_isStopping || m_numberOfQueuedTasks > 0; });
+
+            if (m_numberOfQueuedTasks == 0) return;
+        }
+
+        if (!TryPop(workerIndex, task)) continue;
+
+        m_numberOfQueuedTasks--;
+        task();
+        task = nullptr;
+
+        if (--m_numberOfUnfinishedTasks == 0)
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            m_workDone.notify_all();
+        }
+    }
+}
+
+void ThreadPool::Wait()
+    // Blocks until every submitted task has finished.
+{
+    std::unique_lock<std::mutex> lock(m_stateMutex);
+    m_workDone.wait(lock, [this]() { return m_numberOfUnfinishedTasks == 0; });
+}
@@ -1,93 +1,27 @@
 #include "gameboard.h"
+#include <stdexcept>
 using namespace Gameboard;
 
 
-bool IntVector2::operator==(const IntVector2& other) const
+AssetsHandler::AssetsHandler(const std::vector<std::string>& textureIds, const std::vector<std::string>& fontIds, const std::vector<std::string>& soundIds)
+    : textures(LoadTexture, UnloadTexture, textureIds),
+    fonts(LoadFont, UnloadFont, fontIds),
+    sounds(LoadSound, UnloadSound, soundIds)
 {
-    return x == other.x && y == other.y;
 }
 
 
-AssetsHandler::AssetsHandler() = default;
-
-
-Drawable::Drawable(const IntVector2 dimensions, const IntVector2 margin)
-    : m_dimensions(dimensions), m_margin(margin)
-{
-}
-
-int Drawable::GetWidth() const
-{
-    return m_dimensions.x;
-}
-
-void Drawable::SetWidth(const int width)
-{
-    m_dimensions.x = width;
-}
-
-int Drawable::GetHeight() const
-{
-    return m_dimensions.y;
-}
-
-void Drawable::SetHeight(const int height)
-{
-    m_dimensions.y = height;
-}
-
-int Drawable::GetMarginWidth() const
-{
-    return m_margin.x;
-}
-
-void Drawable::SetMarginWidth(const int marginWidth)
-{
-    m_margin.x = marginWidth;
-}
-
-int Drawable::GetMarginHeight() const
-{
-    return m_margin.y;
-}
-
-void Drawable::SetMarginHeight(const int marginHeight)
-{
-    m_margin.y = marginHeight;
-}
-
-void Drawable::SetPositionOnScreen(const int x, const int y)
-{
-    m_positionOnScreen = { x, y };
-}
-
-IntVector2 Drawable::GetPositionOnScreen() const
-{
-    return m_positionOnScreen;
-}
-
-void Drawable::SetGridCoords(const IntVector2 coords)
-{
-    m_coords = coords;
-}
-
-IntVector2 Drawable::GetGridCoords() const
-{
-    return m_coords;
-}
-
-
-DrawableTexture::DrawableTexture(std::shared_ptr<Texture2D> texture, const IntVector2 pixalDimensions, const IntVector2 margin)
+DrawableTexture::DrawableTexture(const Texture2D& texture, const IntVector2 pixalDimensions, const IntVector2 margin)
     : Drawable(pixalDimensions, margin), m_renderedTexture(texture)
 {
 }
 
-std::shared_ptr<Texture2D> DrawableTexture::GetTexture() const
+const Texture2D& DrawableTexture::GetTexture() const
 {
     return m_renderedTexture;
 }
 
-void DrawableTexture::SetTexture(std::shared_ptr<Texture2D> texture)
+void DrawableTexture::SetTexture(const Texture2D& texture)
 {
 
     m_renderedTexture = texture;
@@ -96,15 +30,15 @@ void DrawableTexture::SetTexture(std::shared_ptr<Texture2D> texture)
 void DrawableTexture::Render() const
 {
     IntVector2 positionOnScreen = GetPositionOnScreen();
-    float scaleY = (float)GetHeight() / (float)m_renderedTexture->height;
-    float scaleX = (float)GetWidth() / (float)m_renderedTexture->width;
+    float scaleY = (float)GetHeight() / (float)m_renderedTexture.height;
+    float scaleX = (float)GetWidth() / (float)m_renderedTexture.width;
 
     float scale = std::min(scaleX, scaleY);
 
-    DrawTextureEx(*m_renderedTexture, { (float)positionOnScreen.x, (float)positionOnScreen.y }, 0, scale, WHITE);
+    DrawTextureEx(m_renderedTexture, { (float)positionOnScreen.x, (float)positionOnScreen.y }, 0, scale, WHITE);
 }
 
-Text::Text(std::string text, int fontSize, Color colour, std::shared_ptr<Font> font) 
+Text::Text(std::string text, int fontSize, Color colour, const Font& font) 
     : Drawable(IntVector2{ MeasureText(text.c_str(), fontSize), 10 }, IntVector2{ 0,0 }),
     m_text(text), m_fontSize(fontSize), m_colour(colour), m_font(font)
 {
@@ -120,6 +54,11 @@ void Text::SetText(const std::string text)
     m_text = text;
 }
 
+void Text::SetFont(const Font& font)
+{
+    m_font = font;
+}
+
 int Text::GetFontSize() const
 {
     return m_fontSize;
@@ -132,12 +71,12 @@ void Text::SetFontSize(const int fontSize)
 
 int Text::GetWidth() const
 {
-    return (int)MeasureTextEx(*m_font, m_text.c_str(), (float)m_fontSize, 0).x;
+    return (int)MeasureTextEx(m_font, m_text.c_str(), (float)m_fontSize, 0).x;
 }
 
 int Text::GetHeight() const
 {
-    return (int)MeasureTextEx(*m_font, m_text.c_str(), (float)m_fontSize, 0).y;
+    return (int)MeasureTextEx(m_font, m_text.c_str(), (float)m_fontSize, 0).y;
 }
 
 AnchorPoints Text::GetAnchorPoint() const
@@ -219,5 +158,5 @@ void Text::SetColour(const Color colour)
 void Text::Render() const
 {
     IntVector2 positionOnScreen = GetPositionOnScreen();
-    DrawTextEx(*m_font, m_text.c_str(), { (float)positionOnScreen.x, (float)positionOnScreen.y }, m_fontSize, 1, m_colour);
+    DrawTextEx(m_font, m_text.c_str(), { (float)positionOnScreen.x, (float)positionOnScreen.y }, m_fontSize, 1, m_colour);
 }
@@ -0,0 +1,229 @@
+#include "gameconfig.h"
+#include "engine/actionlog.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+using namespace Minesweeper;
+
+const char* Minesweeper::defaultConfigFilePath = "./minesweeper.cfg";
+
+namespace
+{
+    struct Preset
+    {
+        const char* name;
+        IntVector2 boardDimensions;
+        int numberOfBombs;
+    };
+
+    constexpr Preset presets[] = {
+        { "beginner", { 9, 9 }, 10 },
+        { "intermediate", { 16, 16 }, 40 },
+        { "expert", { 30, 16 }, 99 }
+    };
+
+    // Auto-fitted tiles stay between these sizes; a board that does not fit at the smallest
+    // is panned and zoomed around instead.
+    constexpr int minTileSize = 4;
+    constexpr int maxTileSize = 40;
+
+    // Window space kept free of the board for the texts around it.
+    constexpr int hudHeight = 120;
+    constexpr int sidePadding = 20;
+
+    std::string Trim(const std::string& text)
+    {
+        const size_t start = text.find_first_not_of(" \t\r");
+        if (start == std::string::npos) return "";
+
+        return text.substr(start, text.find_last_not_of(" \t\r") - start + 1);
+    }
+
+    int ParseInt(const std::string& option, const std::string& value)
+    {
+        size_t length = 0;
+        int number = 0;
+
+        try
+        {
+            number = std::stoi(value, &length);
+        }
+        catch (const std::exception&)
+        {
+            length = 0;
+        }
+
+        if (length == 0 || length != value.size()) throw std::invalid_argument(option + " must be a whole number: " + value);
+        return number;
+    }
+
+    IntVector2 ParseDimensions(const std::string& option, const std::string& value)
+    {
+        const size_t separator = value.find('x');
+        if (separator == std::string::npos) throw std::invalid_argument(option + " must look like WxH: " + value);
+
+        return IntVector2{ ParseInt(option, value.substr(0, separator)), ParseInt(option, value.substr(separator + 1)) };
+    }
+
+    void Validate(const GameConfig& config)
+    {
+        const IntVector2 board = config.boardDimensions;
+
+        if (board.x <= 0 || board.y <= 0) throw std::invalid_argument("Board dimensions must be positive");
+        if ((long long)board.x * board.y > ActionLog::maxNumberOfTiles) throw std::invalid_argument("Board is too big");
+
+        if (config.numberOfBombs < -1 || config.GetNumberOfBombs() > board.x * board.y) throw std::invalid_argument("Number of bombs must fit on the board");
+        if (config.numberOfBombs < 0 && (config.bombDensity < 0.0f || config.bombDensity > 1.0f)) throw std::invalid_argument("Density must be between 0 and 1");
+
+        if (config.tileSize < 0) throw std::invalid_argument("Tile size must not be negative");
+        if (config.windowDimensions.x <= 0 || config.windowDimensions.y <= 0) throw std::invalid_argument("Window dimensions must be positive");
+    }
+}
+
+
+int GameConfig::GetNumberOfBombs() const
+{
+    if (numberOfBombs >= 0) return numberOfBombs;
+    return static_cast<int>((long long)boardDimensions.y * boardDimensions.x * bombDensity);
+}
+
+
+void Minesweeper::ApplyConfigOption(GameConfig& config, const std::string& option, const std::string& value)
+    // Throws std::invalid_argument for unknown options and malformed values.
+{
+    if (option == "preset")
+    {
+        if (value == "custom") return; // Keeps whatever size and bombs are set.
+
+        const Preset* preset = std::find_if(std::begin(presets), std::end(presets), [&](const Preset& candidate) {
+            return value == candidate.name;
+        });
+
+        if (preset == std::end(presets)) throw std::invalid_argument("Unknown preset: " + value);
+
+        config.boardDimensions = preset->boardDimensions;
+        config.numberOfBombs = preset->numberOfBombs;
+    }
+    else if (option == "size") config.boardDimensions = ParseDimensions(option, value);
+    else if (option == "bombs") config.numberOfBombs = ParseInt(option, value);
+    else if (option == "density")
+    {
+        try
+        {
+            config.bombDensity = std::stof(value);
+        }
+        catch (const std::exception&)
+        {
+            throw std::invalid_argument("density must be a number: " + value);
+        }
+
+        config.numberOfBombs = -1;
+    }
+    else if (option == "tile-size") config.tileSize = ParseInt(option, value);
+    else if (option == "window") config.windowDimensions = ParseDimensions(option, value);
+    else if (option == "replay") config.replayFilePath = value;
+    else throw std::invalid_argument("Unknown option: " + option);
+}
+
+void Minesweeper::LoadConfigFile(GameConfig& config, const std::string& filePath)
+    // Blank lines and lines starting with # are skipped.
+{
+    std::ifstream file(filePath);
+    if (!file) throw std::runtime_error("Cannot read " + filePath);
+
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        line = Trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        const size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument(filePath + ":" + std::to_string(lineNumber) + ": expected option = value");
+        }
+
+        try
+        {
+            ApplyConfigOption(config, Trim(line.substr(0, separator)), Trim(line.substr(separator + 1)));
+        }
+        catch (const std::invalid_argument& error)
+        {
+            throw std::invalid_argument(filePath + ":" + std::to_string(lineNumber) + ": " + error.what());
+        }
+    }
+}
+
+GameConfig Minesweeper::ParseGameConfig(const int argc, const char* const* argv)
+{
+    GameConfig config;
+    std::string configFilePath;
+
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--config") configFilePath = argv[i + 1];
+    }
+
+    if (!configFilePath.empty()) LoadConfigFile(config, configFilePath);
+    else if (std::filesystem::exists(defaultConfigFilePath)) LoadConfigFile(config, defaultConfigFilePath);
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string option = argv[i];
+
+        if (option == "--help" || option == "-h")
+        {
+            config.isHelpRequested = true;
+            continue;
+        }
+
+        if (option.rfind("--", 0) != 0) throw std::invalid_argument("Unexpected argument: " + option);
+        if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + option);
+
+        const std::string value = argv[++i];
+        if (option != "--config") ApplyConfigOption(config, option.substr(2), value);
+    }
+
+    Validate(config);
+    return config;
+}
+
+void Minesweeper::PrintGameUsage()
+{
+    std::printf(
+        "Usage: Minesweeper [options]\n"
+        "  --preset beginner|intermediate|expert|custom\n"
+        "                       9x9 with 10 bombs, 16x16 with 40 or 30x16 with 99; custom keeps\n"
+        "                       the size and bombs given elsewhere\n"
+        "  --size WxH           Board size in tiles (default 9x9)\n"
+        "  --bombs N            Number of bombs\n"
+        "  --density D          Share of tiles holding a bomb, when --bombs is not given (default 0.15)\n"
+        "  --tile-size PX       Tile size in pixels, 0 to fit the board to the window (default 0)\n"
+        "  --window WxH         Window size in pixels (default 800x600)\n"
+        "  --replay FILE        Play a recorded game back\n"
+        "  --config FILE        Read options from FILE instead of %s\n",
+        defaultConfigFilePath);
+}
+
+TileLayout Minesweeper::GetTileLayout(const GameConfig& config)
+    // Margins are a quarter of the tile, as in the original 40 pixel tiles with 10 pixel margins.
+{
+    int tileSize = config.tileSize;
+
+    if (tileSize == 0)
+    {
+        // A tile and its margin take 5/4 of the tile size.
+        const int availableWidth = config.windowDimensions.x - 2 * sidePadding;
+        const int availableHeight = config.windowDimensions.y - hudHeight;
+        const int pitch = std::min(availableWidth / config.boardDimensions.x, availableHeight / config.boardDimensions.y);
+
+        tileSize = std::clamp(pitch * 4 / 5, minTileSize, maxTileSize);
+    }
+
+    const int margin = tileSize / 4;
+    return TileLayout{ IntVector2{ tileSize, tileSize }, IntVector2{ margin, margin } };
+}
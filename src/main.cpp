@@ -1,91 +1,271 @@
 #include "raylib.h"
+#include "assetloader.h"
+#include "gameconfig.h"
 #include "minesweeper.h"
+#include "profileroverlay.h"
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <string>
 
 
-int main()
+int main(int argc, char** argv)
 {
-	InitWindow(800, 600, "Minesweeper");
+	// Board, window and tile settings from minesweeper.cfg and the command line
+	Minesweeper::GameConfig config;
+
+	try
+	{
+		config = Minesweeper::ParseGameConfig(argc, argv);
+	}
+	catch (const std::exception& error)
+	{
+		std::fprintf(stderr, "%s\n", error.what());
+		Minesweeper::PrintGameUsage();
+		return 1;
+	}
+
+	if (config.isHelpRequested)
+	{
+		Minesweeper::PrintGameUsage();
+		return 0;
+	}
+
+	// A replay is played back in real time instead of starting a new game
+	const char* replayFilePath = config.replayFilePath.empty() ? nullptr : config.replayFilePath.c_str();
+
+	InitWindow(config.windowDimensions.x, config.windowDimensions.y, "Minesweeper");
 	InitAudioDevice(); 
 	SetTargetFPS(60);
 
-	//Loading assets
-	Minesweeper::assets.textures.LoadAll(LoadDirectoryFiles("./assets/textures"));
-	Minesweeper::assets.fonts.LoadAll(LoadDirectoryFiles("./assets/fonts"));
-	Minesweeper::assets.sounds.LoadAll(LoadDirectoryFiles("./assets/sounds"));
+	// Loading assets in the background, the game starts with placeholders until they arrive
+	Gameboard::AssetLoader loader;
+	loader.QueueTextures(Minesweeper::assets.textures, Minesweeper::atlas, "./assets/textures");
+	loader.QueueFonts(Minesweeper::assets.fonts, "./assets/fonts");
+	loader.QueueSounds(Minesweeper::assets.sounds, "./assets/sounds");
 
 	// Creating Text Instances
-	Gameboard::Text flagsLeft("Flags Left: 0", 20, RED, Minesweeper::assets.fonts.Get("arialroundedmtbold"));
+	Gameboard::Text flagsLeft("Flags Left: 0", 20, RED, Minesweeper::assets.fonts.Get(Minesweeper::FontIds::ARIAL_ROUNDED));
 	flagsLeft.SetPositionOnScreen(GetScreenWidth() - 170, 80);
 
-	Gameboard::Text winText("You found all the bombs!", 50, BLUE, Minesweeper::assets.fonts.Get("arialroundedmtbold"));
+	Gameboard::Text winText("You found all the bombs!", 50, BLUE, Minesweeper::assets.fonts.Get(Minesweeper::FontIds::ARIAL_ROUNDED));
 	winText.SetPositionOnScreen(10, 10);
 
-	Gameboard::Text loseText("You triggered a bomb!", 50, BLUE, Minesweeper::assets.fonts.Get("arialroundedmtbold"));
+	Gameboard::Text loseText("You triggered a bomb!", 50, BLUE, Minesweeper::assets.fonts.Get(Minesweeper::FontIds::ARIAL_ROUNDED));
 	loseText.SetPositionOnScreen(10, 10);
 
-	Gameboard::Text playAgainText("Press ENTER to play again or ESC to exit", 30, BLUE, Minesweeper::assets.fonts.Get("arialroundedmtbold"));
+	Gameboard::Text playAgainText("Press ENTER to play again or ESC to exit", 30, BLUE, Minesweeper::assets.fonts.Get(Minesweeper::FontIds::ARIAL_ROUNDED));
 	playAgainText.SetPositionOnScreen(10, GetScreenHeight() - 50);
 
-	Minesweeper::Tile sampleTile(IntVector2{ 40,40 }, IntVector2{ 10,10 });
 	bool shouldPlayAgain = true;
 
-	while (!WindowShouldClose() || shouldPlayAgain)
+	// A game left unfinished is saved here on exit and continued on the next start
+	const char* snapshotFilePath = "./minesweeper.snapshot";
+	bool isFirstGame = true;
+
+	// The saved game is only deleted once it was continued or another game was finished
+	bool isSnapshotSuperseded = false;
+
+#if MINESWEEPER_PROFILE
+	// F3 shows frame times and the slowest zones; the whole trace is written on exit
+	bool isProfilerShown = false;
+#endif
+
+	// Every game is recorded here, named after its seed
+	const std::filesystem::path replaysDirectory = "./replays";
+	std::error_code replaysDirectoryError;
+	std::filesystem::create_directories(replaysDirectory, replaysDirectoryError);
+
+	// The first game takes the board of the replay, or else of the saved game
+	Minesweeper::GameConfig firstGameConfig = config;
+
+	if (replayFilePath != nullptr)
+	{
+		try
+		{
+			const Minesweeper::ActionLogReader replayLog(replayFilePath);
+			firstGameConfig.boardDimensions = IntVector2{ replayLog.GetHeader().width, replayLog.GetHeader().height };
+			firstGameConfig.numberOfBombs = replayLog.GetHeader().numberOfBombs;
+		}
+		catch (const std::exception& error)
+		{
+			TraceLog(LOG_WARNING, "ACTIONLOG: Cannot replay %s: %s", replayFilePath, error.what());
+			replayFilePath = nullptr;
+		}
+	}
+
+	if (replayFilePath == nullptr && FileExists(snapshotFilePath))
+	{
+		try
+		{
+			const Minesweeper::SnapshotHeader snapshotHeader = Minesweeper::Snapshot::LoadHeader(snapshotFilePath);
+			firstGameConfig.boardDimensions = IntVector2{ snapshotHeader.width, snapshotHeader.height };
+			firstGameConfig.numberOfBombs = snapshotHeader.numberOfBombs;
+		}
+		catch (const std::exception& error)
+		{
+			TraceLog(LOG_WARNING, "SNAPSHOT: Cannot read the saved game %s: %s", snapshotFilePath, error.what());
+		}
+	}
+
 	{
+		// One grid for the whole session, reset in place for every new game. Scoped so its
+		// render textures are unloaded before the window closes
+		const Minesweeper::TileLayout firstTileLayout = Minesweeper::GetTileLayout(firstGameConfig);
+
 		Minesweeper::MinesweeperGrid game(
-			IntVector2{ 9,9 },
-			sampleTile,
+			firstGameConfig.boardDimensions,
+			firstGameConfig.GetNumberOfBombs(),
+			Minesweeper::Tile(firstTileLayout.dimensions, firstTileLayout.margin),
 			Gameboard::AnchorPoints::MIDDLE,
 			IntVector2{ GetScreenWidth() / 2, GetScreenHeight() / 2 }
 		);
 
-		// MAIN GAME LOOP
-		while (true)
+		while (!WindowShouldClose() || shouldPlayAgain)
 		{
-			if (IsKeyPressed(KEY_ESCAPE) || WindowShouldClose())
+			if (!isFirstGame)
 			{
-				shouldPlayAgain = false;
-				break;
+				const Minesweeper::TileLayout tileLayout = Minesweeper::GetTileLayout(config);
+				game.Reset(config.boardDimensions, config.GetNumberOfBombs(), Minesweeper::Tile(tileLayout.dimensions, tileLayout.margin), Minesweeper::MinesweeperGrid::NewSeed());
 			}
 
-			BeginDrawing();
-			ClearBackground(RAYWHITE);
-
-			game.DisplayGrid();
-
-			const int numberOfFlagsLeft = game.GetNumberOfFlagsLeft();
-			flagsLeft.SetText(TextFormat("Flags Left: %d", numberOfFlagsLeft));
-			flagsLeft.Render();
+			// A replay stands in for the saved game, which is left alone
+			const bool isReplay = isFirstGame && replayFilePath != nullptr;
 
+			if (isReplay)
+			{
+				try
+				{
+					game.StartReplay(replayFilePath);
+				}
+				catch (const std::exception& error)
+				{
+					TraceLog(LOG_WARNING, "ACTIONLOG: Cannot replay %s: %s", replayFilePath, error.what());
+				}
+			}
+			else if (isFirstGame && FileExists(snapshotFilePath))
+			{
+				try
+				{
+					game.LoadSnapshot(snapshotFilePath);
+					isSnapshotSuperseded = true;
+				}
+				catch (const std::exception& error)
+				{
+					TraceLog(LOG_WARNING, "SNAPSHOT: Not continuing the saved game: %s", error.what());
+				}
+			}
 
-			if (!game.IsBombTriggered() && game.GetNumberOfBombsLeft() != 0)
+			if (!isReplay && !game.IsInProgress() && !replaysDirectoryError)
 			{
-				game.ProcessMouseInput();
+				game.StartRecording((replaysDirectory / TextFormat("%016llx.mslog", (unsigned long long)game.GetSeed())).string());
 			}
-			else
+
+			isFirstGame = false;
+
+			// MAIN GAME LOOP
+			while (true)
 			{
-				playAgainText.Render();
-				if (IsKeyPressed(KEY_ENTER))
+				if (IsKeyPressed(KEY_ESCAPE) || WindowShouldClose())
 				{
+					if (!isReplay)
+					{
+						try
+						{
+							if (game.IsInProgress()) game.SaveSnapshot(snapshotFilePath);
+							else if (isSnapshotSuperseded && FileExists(snapshotFilePath)) std::remove(snapshotFilePath);
+						}
+						catch (const std::exception& error)
+						{
+							TraceLog(LOG_WARNING, "SNAPSHOT: Could not save the game: %s", error.what());
+						}
+					}
+
+					shouldPlayAgain = false;
 					break;
 				}
 
-				if (game.GetNumberOfBombsLeft() == 0)
+				if (loader.Update())
 				{
-					winText.Render();
+					const Font& font = Minesweeper::assets.fonts.Get(Minesweeper::FontIds::ARIAL_ROUNDED);
+					for (Gameboard::Text* text : { &flagsLeft, &winText, &loseText, &playAgainText }) text->SetFont(font);
 
+					game.RefreshTextures();
+				}
+
+				if (IsKeyPressed(KEY_H)) game.ToggleHints();
+#if MINESWEEPER_PROFILE
+				if (IsKeyPressed(KEY_F3)) isProfilerShown = !isProfilerShown;
+#endif
+				game.UpdateCamera();
+
+				BeginDrawing();
+				ClearBackground(RAYWHITE);
+
+				game.DisplayGrid();
+
+				const int numberOfFlagsLeft = game.GetNumberOfFlagsLeft();
+				flagsLeft.SetText(TextFormat("Flags Left: %d", numberOfFlagsLeft));
+				flagsLeft.Render();
+
+
+				if (!game.IsOver())
+				{
+					game.UpdateTimer();
+
+					if (game.IsReplaying()) game.UpdateReplay();
+					else game.ProcessMouseInput();
 				}
 				else
 				{
-					loseText.Render();
-					game.DisplayBombs();
+					if (!isReplay) isSnapshotSuperseded = true;
+
+					playAgainText.Render();
+					if (IsKeyPressed(KEY_ENTER))
+					{
+						break;
+					}
+
+					if (game.IsWon())
+					{
+						winText.Render();
+
+					}
+					else
+					{
+						loseText.Render();
+						game.DisplayBombs();
 
+					}
 				}
-			}
 
-			EndDrawing();
+#if MINESWEEPER_PROFILE
+				if (isProfilerShown) Gameboard::DrawProfilerOverlay(Minesweeper::Profiler::Get(), IntVector2{ 10, 110 });
+#endif
+
+				{
+					PROFILE_ZONE("EndDrawing");
+					EndDrawing();
+				}
+
+#if MINESWEEPER_PROFILE
+				Minesweeper::Profiler::Get().EndFrame();
+#endif
+			}
 		}
 	}
-	
+
+#if MINESWEEPER_PROFILE
+	try
+	{
+		Minesweeper::Profiler::Get().WriteChromeTrace("./minesweeper.trace.json");
+	}
+	catch (const std::exception& error)
+	{
+		TraceLog(LOG_WARNING, "PROFILER: %s", error.what());
+	}
+#endif
+
 	CloseAudioDevice();
 	CloseWindow();
 	return 0;
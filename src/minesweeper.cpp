@@ -1,296 +1,538 @@
 #include "minesweeper.h"
+#include "engine/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
 using namespace Minesweeper;
 
-Gameboard::AssetsHandler Minesweeper::assets;
+Gameboard::AssetsHandler Minesweeper::assets(TextureIds::names, FontIds::names, SoundIds::names);
+Gameboard::TextureAtlas Minesweeper::atlas;
 
 Tile::Tile(const IntVector2 dimensions, const IntVector2 margin)
-    : DrawableTexture(assets.textures.Get("covered-tile"), dimensions, margin)
+    : Drawable(dimensions, margin)
 {
 }
 
-Tile::ContentOption Tile::GetContentOption() const
+void Tile::Render(const Texture2D& texture, const IntVector2 positionOnScreen) const
 {
-    return m_entityOption;
+    float scale = (float)GetHeight() / texture.height;
+
+    DrawTextureEx(texture, { (float)positionOnScreen.x, (float)positionOnScreen.y }, 0, scale, WHITE);
 }
 
-void Tile::SetContentOption(ContentOption contentOption)
+void Tile::Render() const
 {
-    m_entityOption = contentOption;
+    Render(assets.textures.Get(TextureIds::COVERED_TILE), GetPositionOnScreen());
+}
 
-    switch (m_entityOption)
-    {
-    case ContentOption::BOMB:
-        SetContentTexture(assets.textures.Get("bomb"));
-        break;
 
-    case ContentOption::ONE:
-        SetContentTexture(assets.textures.Get("one"));
-        break;
+MinesweeperGrid::MinesweeperGrid(const IntVector2 dimensions, const int numberOfBombs, const Tile sampleTile, const Gameboard::AnchorPoints anchorPoint, const IntVector2 position, const GenerationOptions generationOptions)
+    : GridLayout(dimensions, sampleTile, anchorPoint),
+    m_board(dimensions, numberOfBombs),
+    m_generationOptions(generationOptions),
+    m_seed(NewSeed()),
+    m_renderCache(*this)
+{
+    RefreshTextures();
+    SetPositionsOnScreen(position);
+    LimitZoomOut();
+}
 
-    case ContentOption::TWO:
-        SetContentTexture(assets.textures.Get("two"));
-        break;
+std::uint64_t MinesweeperGrid::NewSeed()
+{
+    return ((std::uint64_t)std::random_device{}() << 32) | std::random_device{}();
+}
 
-    case ContentOption::THREE:
-        SetContentTexture(assets.textures.Get("three"));
-        break;
+void MinesweeperGrid::Reset(const IntVector2 dimensions, const int numberOfBombs, const Tile sampleTile, const std::uint64_t seed, const GenerationOptions generationOptions)
+    // Starts a new game in place of this one. The board, solver and render cache keep their
+    // buffers (and, for a grid of the same size, their chunk textures), so playing again
+    // costs little more than placing the bombs on the first click. The grid stays anchored
+    // where it was and the hints stay as they were.
+{
+    PROFILE_ZONE("MinesweeperGrid::Reset");
 
-    case ContentOption::FOUR:
-        SetContentTexture(assets.textures.Get("four"));
-        break;
+    m_board.Reset(dimensions, numberOfBombs);
+    Resize(dimensions, sampleTile);
+    m_renderCache.Reset(*this);
 
-    case ContentOption::FIVE:
-        SetContentTexture(assets.textures.Get("five"));
-        break;
+    m_generationOptions = generationOptions;
+    m_seed = seed;
+    m_elapsedSeconds = 0.0;
+    m_areBombsDisplayed = false;
 
-    case ContentOption::SIX:
-        SetContentTexture(assets.textures.Get("six"));
-        break;
+    m_actionLogFilePath.clear();
+    m_actionLog.reset();
 
-    case ContentOption::SEVEN:
-        SetContentTexture(assets.textures.Get("seven"));
-        break;
+    m_replayLog.reset();
+    m_nextReplayAction = 0;
+    m_replaySeconds = 0.0;
 
-    case ContentOption::EIGHT:
-        SetContentTexture(assets.textures.Get("eight"));
-        break;
+    m_camera = Gameboard::GridCamera();
+    LimitZoomOut();
 
-    default:
-        break;
-    }
+    if (m_areHintsShown) m_solver.Reset(m_board);
 }
 
-std::shared_ptr<Texture2D> Tile::GetContentTexture() const
+const Gameboard::AtlasRegion& MinesweeperGrid::GetContentRegion(const int index) const
 {
-    return m_contentTexture;
+    if (m_board.IsBomb(index)) return m_bombRegion;
+    return m_numberRegions[(int)m_board.GetContentOption(index)];
 }
 
-void Tile::SetContentTexture(std::shared_ptr<Texture2D> texture)
+Rectangle MinesweeperGrid::GetCellRectangle(const IntVector2 coords) const
 {
-    m_contentTexture = texture;
+    const IntVector2 positionOnScreen = GetCellPositionOnScreen(coords);
+    return Rectangle{ (float)positionOnScreen.x, (float)positionOnScreen.y, (float)m_cellDimensions.x, (float)m_cellDimensions.y };
 }
 
-bool Tile::IsTileCovered() const
+Camera2D MinesweeperGrid::GetCamera2D() const
 {
-    return m_isCovered;
-}
+    const Gameboard::FloatVector2 offset = m_camera.GetOffset();
+    const Gameboard::FloatVector2 target = m_camera.GetTarget();
 
-void Tile::ToggleCovered()
-{
-    m_isCovered = !m_isCovered;
+    return Camera2D{ { offset.x, offset.y }, { target.x, target.y }, 0.0f, m_camera.GetZoom() };
 }
 
-bool Tile::IsTileFlagged() const
+void MinesweeperGrid::LimitZoomOut()
+    // Zoomed out, every visible tile is queued each frame, so on big boards the view is kept
+    // under maxVisibleTiles to bound the frame time and the size of the quad batch.
 {
-    return m_isFlagged;
+    constexpr float maxVisibleTiles = 1 << 18;
+
+    const IntVector2 pitch = GetPitch();
+    const float screenArea = (float)GetScreenWidth() * GetScreenHeight();
+    const float minZoom = std::sqrt(screenArea / (maxVisibleTiles * pitch.x * pitch.y));
+
+    m_camera.SetZoomLimits(std::clamp(minZoom, m_camera.GetMinZoom(), 1.0f), m_camera.GetMaxZoom());
 }
 
-void Tile::ToggleFlag()
+bool MinesweeperGrid::GetCellUnderMouse(IntVector2& coords) const
 {
-    m_isFlagged = !m_isFlagged;
+    const Vector2 mousePosition = GetMousePosition();
+    return GetCellAt(m_camera, Gameboard::FloatVector2{ mousePosition.x, mousePosition.y }, coords);
 }
 
-void Tile::Render() const
+void MinesweeperGrid::RenderTile(const IntVector2 coords) const
+    // Queues the tile's quads; nothing is drawn until DisplayGrid() flushes the batch.
 {
-    IntVector2 positionOnScreen = GetPositionOnScreen();
-    float scale = (float)GetHeight() / GetTexture()->height;
+    const int index = m_board.GetIndex(coords);
+    const Rectangle cell = GetCellRectangle(coords);
 
-    DrawTextureEx(*GetTexture(), { (float)positionOnScreen.x, (float)positionOnScreen.y }, 0, scale, WHITE);
-
-    if (IsTileFlagged() && IsTileCovered())
+    if (!m_board.IsTileCovered(index))
     {
-        DrawTextureEx(*m_flagTexture, { (float)positionOnScreen.x, (float)positionOnScreen.y }, 0, scale, WHITE);
+        m_quadBatch.Add(GetContentRegion(index), cell);
+        return;
     }
-}
 
+    if (!m_board.IsTileFlagged(index))
+    {
+        m_quadBatch.Add(m_coveredRegion, cell);
+        return;
+    }
 
-MinesweeperGrid::MinesweeperGrid(const IntVector2 dimensions, const Tile sampleTile, const Gameboard::AnchorPoints anchorPoint, const IntVector2 position)
-    : Grid(dimensions, sampleTile, anchorPoint, position)
-{
-    m_numberOfBombs = static_cast<int>(dimensions.y * dimensions.x * m_bombDensity);
-    m_numberOfBombsLeft = m_numberOfBombs;
-    m_numberOfFlagsLeft = m_numberOfBombs;
+    if (m_areBombsDisplayed && !m_board.IsBomb(index))
+    {
+        m_quadBatch.Add(m_incorrectRegion, cell);
+        return;
+    }
 
-    PlaceBombsOnBoard();
+    m_quadBatch.Add(m_coveredRegion, cell);
+    m_quadBatch.Add(m_flagRegion, cell);
 }
 
-int MinesweeperGrid::GetNumberOfBombsAroundTile(const Tile& tile) const
+void MinesweeperGrid::RenderHints(const IntVector2 first, const IntVector2 last) const
+    // Tints the visible covered tiles from green (certainly safe) to red (certainly a bomb).
+    // Drawn over the tiles rather than into the render cache: a reveal can shift the
+    // probabilities anywhere on the board, and redrawing every chunk for it is far slower.
 {
-    int count = 0;
-    const std::vector<Tile> neighbours = GetNeighbours(tile);
+    if (!m_areHintsShown || !m_board.IsGenerated() || m_areBombsDisplayed) return;
 
-    for (auto const& neighbour : neighbours)
+    PROFILE_ZONE("MinesweeperGrid::RenderHints");
+
+    for (int y = first.y; y <= last.y; y++)
     {
-        if (neighbour.GetContentOption() == Tile::ContentOption::BOMB) count++;
+        for (int x = first.x; x <= last.x; x++)
+        {
+            const int index = m_board.GetIndex(IntVector2{ x, y });
+            if (!m_board.IsTileCovered(index) || m_board.IsTileFlagged(index)) continue;
+
+            const float probability = m_solver.GetBombProbability(m_board, index);
+            const Color tint = {
+                (unsigned char)(255 * probability),
+                (unsigned char)(255 * (1.0f - probability)),
+                0,
+                m_solver.IsKnownSafe(index) || m_solver.IsKnownBomb(index) ? (unsigned char)140 : (unsigned char)70
+            };
+
+            m_quadBatch.Add(m_whiteRegion, GetCellRectangle(IntVector2{ x, y }), tint);
+        }
     }
-
-    return count;
 }
 
-void MinesweeperGrid::PlaceBombsOnBoard()
+void MinesweeperGrid::RenderHover() const
+    // Lightens the covered tile under the mouse.
 {
-    while (m_bombCoordinates.size() < m_numberOfBombs) {
-        m_bombCoordinates.insert({
-            GetRandomValue(0, (int)m_grid[0].size() - 1),
-            GetRandomValue(0, (int)m_grid.size() - 1)
-            });
-    }
+    if (m_areBombsDisplayed) return;
 
-    for (const auto& [x, y] : m_bombCoordinates) {
-        m_grid[y][x].SetContentOption(Tile::ContentOption::BOMB);
-        m_grid[y][x].SetContentTexture(assets.textures.Get("bomb"));
-    }
+    IntVector2 coords;
+    if (!GetCellUnderMouse(coords) || !m_board.IsTileCovered(coords)) return;
 
-    // Simplified number assignment
-    for (int y = 0; y < m_grid.size(); y++) {
-        for (int x = 0; x < m_grid[0].size(); x++) {
-            if (m_grid[y][x].GetContentOption() != Tile::ContentOption::BOMB) {
-                int bombCount = GetNumberOfBombsAroundTile(m_grid[y][x]);
-                m_grid[y][x].SetContentOption(static_cast<Tile::ContentOption>(bombCount));
-            }
+    m_quadBatch.Add(m_whiteRegion, GetCellRectangle(coords), Fade(WHITE, 0.25f));
+}
+
+void MinesweeperGrid::RenderTiles(const IntVector2 first, const IntVector2 last) const
+{
+    for (int y = first.y; y <= last.y; y++)
+    {
+        for (int x = first.x; x <= last.x; x++)
+        {
+            RenderTile(IntVector2{ x, y });
         }
     }
 }
 
-void MinesweeperGrid::ClearEmptyNeighbours(const Tile& homeTile)
+void MinesweeperGrid::DisplayGrid() const
+    // Only the cells inside the window are visited, so the cost follows the view, not the board.
+    // Up to 1:1 zoom the tiles come from the render cache, so an idle frame is a blit per chunk;
+    // zoomed in, few tiles are visible and drawing them directly keeps them sharp.
 {
-    std::vector<Tile> neighbours = GetNeighbours(homeTile);
-    std::vector<Tile> clearedNeighbours;
+    PROFILE_ZONE("MinesweeperGrid::DisplayGrid");
 
-    for (auto& neighbour : neighbours)
-    {
-        if (neighbour.GetContentOption() == Tile::ContentOption::BOMB) continue;
-        if (!neighbour.IsTileCovered()) continue;
+    IntVector2 first, last;
+    if (!GetVisibleCells(m_camera, IntVector2{ GetScreenWidth(), GetScreenHeight() }, first, last)) return;
 
-        IntVector2 coords = neighbour.GetGridCoords();
-        Tile& tile = m_grid[coords.y][coords.x];
+    const bool isCached = m_camera.GetZoom() <= 1.0f && m_renderCache.Update(*this, first, last, m_quadBatch, [this](const IntVector2 coords) {
+        RenderTile(coords);
+    });
 
-        tile.SetTexture(neighbour.GetContentTexture());
-        tile.ToggleCovered();
+    if (!isCached) RenderTiles(first, last);
 
-        clearedNeighbours.push_back(neighbour);
-    }
+    RenderHints(first, last);
+    RenderHover();
 
-    for (auto& clearedNeighbour : clearedNeighbours)
+    BeginMode2D(GetCamera2D());
+    if (isCached) m_renderCache.Draw(*this, first, last);
+    m_quadBatch.Draw();
+    EndMode2D();
+}
+
+void MinesweeperGrid::MarkRevealedTilesDirty()
+{
+    for (const TileSpan& span : m_board.GetRevealedTiles())
     {
-        if (clearedNeighbour.GetContentOption() != Tile::ContentOption::EMPTY) continue;
-        ClearEmptyNeighbours(clearedNeighbour); // Need to coords of tile.
+        m_renderCache.MarkDirty(span.y, span.startX, span.endX);
     }
 }
 
-bool MinesweeperGrid::IsTileUnderMouse(const Tile& tile, const Vector2& mousePosition) const
+void MinesweeperGrid::PlayTileSound(const Gameboard::AssetHandle<Sound> sound) const
 {
-    const IntVector2 pos = tile.GetPositionOnScreen();
-    return
-        pos.x < mousePosition.x && pos.x + tile.GetWidth() > mousePosition.x &&
-        pos.y < mousePosition.y && pos.y + tile.GetHeight() > mousePosition.y;
+    PROFILE_ZONE("PlaySound");
+
+    PlaySound(assets.sounds.Get(sound));
 }
 
-void MinesweeperGrid::HandleRightClick(Tile& tile)
+void MinesweeperGrid::RecordAction(const ActionType type, const IntVector2 coords)
+    // A log that cannot be written is given up on; the game itself carries on.
 {
-    if (!tile.IsTileCovered()) return;
+    if (m_actionLogFilePath.empty()) return;
 
-    if (tile.IsTileFlagged()) // Flag Remove
+    try
     {
-        if (tile.GetContentOption() == Tile::ContentOption::BOMB) m_numberOfBombsLeft += 1;
-        m_numberOfFlagsLeft += 1;
-        PlaySound(*assets.sounds.Get("flag-up"));
+        if (m_actionLog == nullptr)
+        {
+            const ActionLogHeader header = ActionLog::CreateHeader(m_dimensions, m_board.GetNumberOfBombs(), m_generationOptions, m_seed);
+            m_actionLog = std::make_unique<ActionLogWriter>(m_actionLogFilePath, header);
+        }
 
+        m_actionLog->Append(Action{ (std::uint32_t)(m_elapsedSeconds * 1000.0), m_board.GetIndex(coords), type });
     }
-    else // Flag Add
+    catch (const std::exception& error)
     {
-        if (m_numberOfFlagsLeft <= 0) return;
-        if (tile.GetContentOption() == Tile::ContentOption::BOMB) m_numberOfBombsLeft -= 1;
-        m_numberOfFlagsLeft -= 1;
-        PlaySound(*assets.sounds.Get("flag-down"));
-    }
+        TraceLog(LOG_WARNING, "ACTIONLOG: Stopped recording to %s: %s", m_actionLogFilePath.c_str(), error.what());
 
-    tile.ToggleFlag();
+        m_actionLogFilePath.clear();
+        m_actionLog.reset();
+    }
 }
 
-void MinesweeperGrid::HandleLeftClick(Tile& tile)
+void MinesweeperGrid::HandleRightClick(const IntVector2 coords)
 {
-    if (!tile.IsTileCovered() || tile.IsTileFlagged()) return;
-
-    tile.ToggleCovered();
-    tile.SetTexture(tile.GetContentTexture());
-    PlaySound(*assets.sounds.Get("uncover"));
+    if (!m_board.IsGenerated()) return;
 
-    switch (tile.GetContentOption()) {
-    case Tile::ContentOption::EMPTY:
-        ClearEmptyNeighbours(tile);
+    switch (m_board.ToggleFlag(coords))
+    {
+    case Board::FlagResult::FLAG_REMOVED:
+        RecordAction(ActionType::UNFLAG, coords);
+        m_renderCache.MarkDirty(coords);
+        PlayTileSound(SoundIds::FLAG_UP);
         break;
-    case Tile::ContentOption::BOMB:
-        m_isBombTriggered = true;
-        PlaySound(*assets.sounds.Get("explosion"));
+    case Board::FlagResult::FLAG_ADDED:
+        RecordAction(ActionType::FLAG, coords);
+        m_renderCache.MarkDirty(coords);
+        PlayTileSound(SoundIds::FLAG_DOWN);
         break;
     default:
         break;
     }
 }
 
+void MinesweeperGrid::HandleLeftClick(const IntVector2 coords)
+{
+    if (!m_board.IsGenerated()) GenerateBoard(m_board, coords, m_generationOptions, m_seed);
+
+    const Board::RevealResult result = m_board.Reveal(coords);
+    if (result == Board::RevealResult::NOTHING) return;
+
+    RecordAction(ActionType::REVEAL, coords);
+    OnTilesRevealed(result);
+}
+
+void MinesweeperGrid::HandleChord(const IntVector2 coords)
+    // The whole chord is one board operation, so it is recorded, redrawn and heard once.
+{
+    const Board::RevealResult result = m_board.Chord(coords);
+    if (result == Board::RevealResult::NOTHING) return;
+
+    RecordAction(ActionType::CHORD, coords);
+    OnTilesRevealed(result);
+}
+
+void MinesweeperGrid::OnTilesRevealed(const Board::RevealResult result)
+{
+    MarkRevealedTilesDirty();
+
+    // The hint tints are drawn over the cache, so only the revealed tiles need redrawing.
+    if (m_areHintsShown) m_solver.Update(m_board, m_board.GetRevealedTiles());
+
+    PlayTileSound(SoundIds::UNCOVER);
+    if (result == Board::RevealResult::EXPLODED) PlayTileSound(SoundIds::EXPLOSION);
+}
+
 void MinesweeperGrid::ProcessMouseInput()
+    // The middle button, or pressing one of left and right while the other is held, chords.
+    // On a revealed tile the first of the two buttons does nothing, so it cannot get in the way.
 {
-    if (!(IsMouseButtonPressed(MOUSE_BUTTON_LEFT) || IsMouseButtonPressed(MOUSE_BUTTON_RIGHT))) return;
+    PROFILE_ZONE("MinesweeperGrid::ProcessMouseInput");
+
+    const bool isLeftPressed = IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+    const bool isRightPressed = IsMouseButtonPressed(MOUSE_BUTTON_RIGHT);
+    const bool isChordPressed = IsMouseButtonPressed(MOUSE_BUTTON_MIDDLE)
+        || (isLeftPressed && IsMouseButtonDown(MOUSE_BUTTON_RIGHT))
+        || (isRightPressed && IsMouseButtonDown(MOUSE_BUTTON_LEFT));
 
-    Vector2 mousePosition = GetMousePosition();
-    bool isClickedTileFound = false;
+    if (!(isLeftPressed || isRightPressed || isChordPressed)) return;
 
-    for (auto& row : m_grid)
+    IntVector2 coords;
+    if (!GetCellUnderMouse(coords)) return;
+
+    if (isChordPressed) HandleChord(coords);
+    else if (isLeftPressed) HandleLeftClick(coords);
+    else HandleRightClick(coords);
+}
+
+void MinesweeperGrid::UpdateCamera()
+    // Arrow keys or WASD pan, the mouse wheel zooms around the cursor and HOME resets the view.
+{
+    constexpr float panSpeed = 800.0f;  // Screen pixels per second.
+    constexpr float zoomStep = 1.1f;    // Per wheel notch.
+
+    const float distance = panSpeed * GetFrameTime();
+    Gameboard::FloatVector2 pan = { 0.0f, 0.0f };
+
+    if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) pan.x += distance;
+    if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) pan.x -= distance;
+    if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) pan.y += distance;
+    if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) pan.y -= distance;
+
+    m_camera.Pan(pan);
+
+    const float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f)
     {
-        for (auto& tile : row)
-        {
-            if (!IsTileUnderMouse(tile, mousePosition)) continue;
+        const Vector2 mousePosition = GetMousePosition();
+        m_camera.ZoomAt(Gameboard::FloatVector2{ mousePosition.x, mousePosition.y }, std::pow(zoomStep, wheel));
+    }
+
+    if (IsKeyPressed(KEY_HOME)) m_camera.Reset();
+}
+
+void MinesweeperGrid::UpdateTimer()
+{
+    if (IsInProgress()) m_elapsedSeconds += GetFrameTime();
+}
+
+bool MinesweeperGrid::IsInProgress() const
+    // Generated and not over yet. The timer, input and saving on exit all go by this.
+{
+    return m_board.IsGenerated() && !IsOver();
+}
+
+bool MinesweeperGrid::IsWon() const
+    // Won by uncovering every safe tile or by flagging every bomb.
+{
+    return m_board.IsGenerated() && !m_board.IsBombTriggered() && (m_board.IsCleared() || m_board.GetNumberOfBombsLeft() == 0);
+}
+
+bool MinesweeperGrid::IsOver() const
+{
+    return m_board.IsBombTriggered() || IsWon();
+}
+
+std::uint64_t MinesweeperGrid::GetSeed() const
+{
+    return m_seed;
+}
+
+void MinesweeperGrid::SaveSnapshot(const std::string& filePath) const
+{
+    Snapshot::Save(filePath, m_board, SnapshotInfo{ m_seed, (std::int64_t)(m_elapsedSeconds * 1000.0) });
+}
+
+void MinesweeperGrid::LoadSnapshot(const std::string& filePath)
+    // Continues a saved game. The snapshot must be of a board the size of this grid; if it is
+    // not, or cannot be read, this throws and the current game is left as it was.
+{
+    Board board(IntVector2{ 1, 1 }, 0);
+    SnapshotInfo info;
+    Snapshot::Load(filePath, board, info);
+
+    if (!(board.GetDimensions() == m_dimensions)) throw std::invalid_argument("Snapshot is of a board of another size");
+
+    m_board = std::move(board);
+    m_seed = info.seed;
+
+    // The log could not rebuild a game that did not start from its seed.
+    m_actionLogFilePath.clear();
+    m_actionLog.reset();
+    m_elapsedSeconds = info.elapsedMilliseconds / 1000.0;
+    m_areBombsDisplayed = false;
+
+    if (m_areHintsShown) m_solver.Reset(m_board);
+    m_renderCache.MarkAllDirty();
+}
+
+void MinesweeperGrid::StartRecording(const std::string& filePath)
+    // Logs the actions of the game from here on, so it must be called before the first click.
+{
+    m_actionLogFilePath = filePath;
+    m_actionLog.reset();
+}
+
+void MinesweeperGrid::StartReplay(const std::string& filePath)
+    // Replaces the game with the one logged in filePath, which must be of a board the size of
+    // this grid, and plays it back in real time through UpdateReplay().
+{
+    std::unique_ptr<ActionLogReader> log = std::make_unique<ActionLogReader>(filePath);
+    const ActionLogHeader& header = log->GetHeader();
+
+    if (!(IntVector2{ header.width, header.height } == m_dimensions)) throw std::invalid_argument("Action log is of a board of another size");
+
+    const int numberOfThreads = m_generationOptions.numberOfThreads;
+    m_generationOptions = ActionLog::GetGenerationOptions(header);
+    m_generationOptions.numberOfThreads = numberOfThreads;
+
+    m_board.Reset(m_dimensions, header.numberOfBombs);
+    m_seed = header.seed;
+    m_elapsedSeconds = 0.0;
+    m_areBombsDisplayed = false;
+
+    m_actionLogFilePath.clear();
+    m_actionLog.reset();
+
+    m_replayLog = std::move(log);
+    m_nextReplayAction = 0;
+    m_replaySeconds = 0.0;
+
+    if (m_areHintsShown) m_solver.Reset(m_board);
+    m_renderCache.MarkAllDirty();
+}
+
+bool MinesweeperGrid::IsReplaying() const
+{
+    return m_replayLog != nullptr && m_nextReplayAction < m_replayLog->GetNumberOfActions();
+}
+
+void MinesweeperGrid::UpdateReplay()
+    // Actions go through the same handlers as clicks, so they are drawn and heard the same way.
+{
+    if (!IsReplaying()) return;
+
+    m_replaySeconds += GetFrameTime();
+
+    while (IsReplaying())
+    {
+        const Action action = m_replayLog->GetAction(m_nextReplayAction);
+        if (action.milliseconds > m_replaySeconds * 1000.0) break;
 
-            if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) HandleLeftClick(tile);
-            else if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) HandleRightClick(tile);
+        m_nextReplayAction++;
+        const IntVector2 coords = m_board.GetCoords(action.index);
 
-            isClickedTileFound = true;
+        switch (action.type)
+        {
+        case ActionType::REVEAL:
+            HandleLeftClick(coords);
+            break;
+        case ActionType::FLAG:
+        case ActionType::UNFLAG:
+            HandleRightClick(coords);
+            break;
+        case ActionType::CHORD:
+            HandleChord(coords);
+            break;
+        default:
             break;
         }
-
-        if (isClickedTileFound) break;
     }
 }
 
 bool MinesweeperGrid::IsBombTriggered() const
 {
-    return m_isBombTriggered;
+    return m_board.IsBombTriggered();
 }
 
 int MinesweeperGrid::GetNumberOfFlagsLeft() const
 {
-    return m_numberOfFlagsLeft;
+    return m_board.GetNumberOfFlagsLeft();
 }
 
 int MinesweeperGrid::GetNumberOfBombsLeft() const
 {
-    return m_numberOfBombsLeft;
+    return m_board.GetNumberOfBombsLeft();
 }
 
 void MinesweeperGrid::DisplayBombs()
 {
-    for (const auto& [x, y] : m_bombCoordinates) {
-        if (m_grid[y][x].IsTileFlagged() && m_grid[y][x].GetContentOption() == Tile::ContentOption::BOMB) continue;
-        if (!m_grid[y][x].IsTileCovered()) continue;
-        m_grid[y][x].SetTexture(m_grid[y][x].GetContentTexture());
-        m_grid[y][x].ToggleCovered();
-    }
+    if (m_areBombsDisplayed) return;
 
-    for (auto& row : m_grid)
-    {
-        for (auto& tile : row)
-        {
-            int x = tile.GetGridCoords().x;
-            int y = tile.GetGridCoords().y;
+    m_board.RevealBombs();
+    m_areBombsDisplayed = true;
 
-            if (!tile.IsTileFlagged()) continue;
-            if (tile.GetContentOption() == Tile::ContentOption::BOMB) continue;
+    // Wrong flags change too, not only the revealed bombs.
+    m_renderCache.MarkAllDirty();
+}
 
-            m_grid[y][x].SetTexture(assets.textures.Get("incorrect"));
-            m_grid[y][x].ToggleFlag();
-        }
+void MinesweeperGrid::ToggleHints()
+{
+    m_areHintsShown = !m_areHintsShown;
+    if (m_areHintsShown) m_solver.Reset(m_board);
+}
+
+void MinesweeperGrid::RefreshTextures()
+    // Picks up atlas regions again, e.g. once textures loaded in the background have arrived.
+{
+    const char* numberTextureNames[] = { "empty-tile", "one", "two", "three", "four", "five", "six", "seven", "eight" };
+
+    m_coveredRegion = atlas.Get("covered-tile");
+    m_flagRegion = atlas.Get("flag");
+    m_incorrectRegion = atlas.Get("incorrect");
+    m_bombRegion = atlas.Get("bomb");
+    m_whiteRegion = atlas.Get(Gameboard::TextureAtlas::whiteRegionName);
+
+    for (size_t i = 0; i < m_numberRegions.size(); i++)
+    {
+        m_numberRegions[i] = atlas.Get(numberTextureNames[i]);
     }
 
-    m_bombCoordinates.clear();
+    m_renderCache.MarkAllDirty();
 }
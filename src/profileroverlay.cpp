@@ -0,0 +1,82 @@
+#include "profileroverlay.h"
+
+#if MINESWEEPER_PROFILE
+
+#include <algorithm>
+
+namespace
+{
+    constexpr int panelWidth = 380;
+    constexpr int panelHeight = 250;
+    constexpr int fontSize = 10;
+    constexpr int lineHeight = 12;
+
+    // Frame times are bucketed by 2 ms up to 40 ms, longer frames share the last bucket.
+    constexpr int numberOfBuckets = 21;
+    constexpr double bucketMilliseconds = 2.0;
+    constexpr int histogramHeight = 60;
+
+    constexpr int maxZonesShown = 10;
+}
+
+
+void Gameboard::DrawProfilerOverlay(const Minesweeper::Profiler& profiler, const IntVector2 position)
+{
+    DrawRectangle(position.x, position.y, panelWidth, panelHeight, Fade(BLACK, 0.75f));
+
+    const std::vector<Minesweeper::Profiler::FrameStats> frames = profiler.GetFrames();
+    if (frames.empty()) return;
+
+    int buckets[numberOfBuckets] = {};
+    double totalMilliseconds = 0.0;
+    double maxMilliseconds = 0.0;
+
+    for (const Minesweeper::Profiler::FrameStats& frame : frames)
+    {
+        buckets[std::min((int)(frame.milliseconds / bucketMilliseconds), numberOfBuckets - 1)]++;
+        totalMilliseconds += frame.milliseconds;
+        maxMilliseconds = std::max(maxMilliseconds, frame.milliseconds);
+    }
+
+    const Minesweeper::Profiler::FrameStats& lastFrame = frames.back();
+    int y = position.y + 6;
+
+    DrawText(TextFormat("frame %.2f ms   mean %.2f   max %.2f   allocations %lld",
+        lastFrame.milliseconds, totalMilliseconds / frames.size(), maxMilliseconds, lastFrame.allocations), position.x + 6, y, fontSize, WHITE);
+    y += lineHeight + 4;
+
+    // Green up to 60 fps, orange up to 30 fps, red beyond.
+    const int bucketWidth = (panelWidth - 12) / numberOfBuckets;
+    const int mostFrames = *std::max_element(buckets, buckets + numberOfBuckets);
+
+    for (int i = 0; i < numberOfBuckets; i++)
+    {
+        const int height = buckets[i] * histogramHeight / std::max(mostFrames, 1);
+        const double bucketStart = i * bucketMilliseconds;
+        const Color colour = bucketStart < 16.0 ? GREEN : (bucketStart < 32.0 ? ORANGE : RED);
+
+        DrawRectangle(position.x + 6 + i * bucketWidth, y + histogramHeight - height, bucketWidth - 1, height, colour);
+    }
+
+    y += histogramHeight + 2;
+    DrawText("0", position.x + 6, y, fontSize, LIGHTGRAY);
+    DrawText("20 ms", position.x + 6 + (numberOfBuckets / 2) * bucketWidth, y, fontSize, LIGHTGRAY);
+    DrawText("40+", position.x + 6 + (numberOfBuckets - 1) * bucketWidth, y, fontSize, LIGHTGRAY);
+    y += lineHeight + 4;
+
+    const std::vector<Minesweeper::Profiler::ZoneTotal>& zones = profiler.GetLastFrameZones();
+
+    for (int i = 0; i < std::min((int)zones.size(), maxZonesShown); i++)
+    {
+        DrawText(zones[i].name, position.x + 6, y, fontSize, WHITE);
+        DrawText(TextFormat("%8.3f ms  x%d", zones[i].milliseconds, zones[i].count), position.x + 250, y, fontSize, WHITE);
+        y += lineHeight;
+    }
+
+    if (profiler.GetNumberOfDroppedEvents() > 0)
+    {
+        DrawText(TextFormat("%lld zones dropped", profiler.GetNumberOfDroppedEvents()), position.x + 6, position.y + panelHeight - lineHeight - 2, fontSize, RED);
+    }
+}
+
+#endif
@@ -0,0 +1,400 @@
+#include "renderer.h"
+#include "rlgl.h"
+#include "engine/profiler.h"
+#include <algorithm>
+using namespace Gameboard;
+
+
+TextureAtlas::~TextureAtlas()
+{
+    UnloadAll();
+}
+
+void TextureAtlas::AddCell(const std::string& id, const Image& image)
+    // Images are scaled into cellSize squares, filled row by row into pageSize pages.
+{
+    constexpr int cellsPerRow = pageSize / cellSize;
+    constexpr int cellsPerPage = cellsPerRow * cellsPerRow;
+
+    const int page = m_numberOfCells / cellsPerPage;
+    const int cell = m_numberOfCells % cellsPerPage;
+    m_numberOfCells++;
+
+    if (page == (int)m_pageImages.size()) m_pageImages.push_back(GenImageColor(pageSize, pageSize, BLANK));
+
+    const Rectangle destination = {
+        (float)(cell % cellsPerRow * cellSize),
+        (float)(cell / cellsPerRow * cellSize),
+        (float)cellSize,
+        (float)cellSize
+    };
+
+    ImageDraw(&m_pageImages[page], image, Rectangle{ 0, 0, (float)image.width, (float)image.height }, destination, WHITE);
+    m_regions[id] = AtlasRegion{ page, destination };
+    m_isUploaded = false;
+}
+
+void TextureAtlas::AddBuiltInCells()
+    // A plain white cell for tinted overlays and a grey one standing in for missing images.
+{
+    Image white = GenImageColor(cellSize, cellSize, WHITE);
+    AddCell(whiteRegionName, white);
+    UnloadImage(white);
+
+    Image placeholder = GenImageColor(cellSize, cellSize, LIGHTGRAY);
+    AddCell(placeholderRegionName, placeholder);
+    UnloadImage(placeholder);
+}
+
+void TextureAtlas::Add(const std::string& id, const Image& image)
+{
+    if (m_numberOfCells == 0) AddBuiltInCells();
+    if (IsImageReady(image)) AddCell(id, image);
+}
+
+void TextureAtlas::Upload()
+    // Creates or refreshes the page textures from their images. Only needs the main thread
+    // and, with nothing added since the last call, does nothing.
+{
+    if (m_numberOfCells == 0) AddBuiltInCells();
+    if (m_isUploaded) return;
+
+    for (int page = 0; page < (int)m_pageImages.size(); page++)
+    {
+        if (page < (int)m_pages.size()) UpdateTexture(m_pages[page], m_pageImages[page].data);
+        else m_pages.push_back(LoadTextureFromImage(m_pageImages[page]));
+    }
+
+    m_isUploaded = true;
+}
+
+void TextureAtlas::LoadAll(FilePathList imagesFilePaths)
+{
+    UnloadAll();
+
+    for (unsigned int i = 0; i < imagesFilePaths.count; i++)
+    {
+        const char* filePath = imagesFilePaths.paths[i];
+        if (!IsPathFile(filePath)) continue;
+
+        Image image = LoadImage(filePath);
+        Add(GetFileNameWithoutExt(filePath), image);
+        UnloadImage(image);
+    }
+
+    Upload();
+}
+
+void TextureAtlas::UnloadAll()
+{
+    for (const Texture2D& page : m_pages) UnloadTexture(page);
+    for (const Image& pageImage : m_pageImages) UnloadImage(pageImage);
+
+    m_pages.clear();
+    m_pageImages.clear();
+    m_regions.clear();
+    m_numberOfCells = 0;
+    m_isUploaded = true;
+}
+
+AtlasRegion TextureAtlas::Get(const std::string& id) const
+    // Images that are not in the atlas (yet) are drawn as the placeholder cell.
+{
+    const auto it = m_regions.find(id);
+    if (it != m_regions.end()) return it->second;
+
+    return m_regions.at(placeholderRegionName);
+}
+
+const Texture2D& TextureAtlas::GetPage(const int page) const
+{
+    return m_pages.at(page);
+}
+
+int TextureAtlas::GetNumberOfPages() const
+{
+    return (int)m_pages.size();
+}
+
+
+QuadBatch::QuadBatch(const TextureAtlas& atlas)
+    : m_atlas(atlas)
+{
+}
+
+void QuadBatch::Add(const AtlasRegion& region, const Rectangle& destination, const Color tint)
+{
+    if (region.page >= (int)m_quadsByPage.size()) m_quadsByPage.resize(region.page + 1);
+
+    m_quadsByPage[region.page].push_back(Quad{ region.source, destination, tint });
+}
+
+void QuadBatch::Draw()
+    // Quads keep their submission order within a page, so overlays added after a tile
+    // land on top of it. Buffers are cleared but keep their capacity for the next frame.
+{
+    PROFILE_ZONE("QuadBatch::Draw");
+
+    const float pageSize = (float)TextureAtlas::pageSize;
+
+    for (int page = 0; page < (int)m_quadsByPage.size(); page++)
+    {
+        std::vector<Quad>& quads = m_quadsByPage[page];
+        if (quads.empty()) continue;
+
+        rlSetTexture(m_atlas.GetPage(page).id);
+        rlBegin(RL_QUADS);
+
+        for (const Quad& quad : quads)
+        {
+            rlCheckRenderBatchLimit(4);
+
+            const float left = quad.source.x / pageSize;
+            const float right = (quad.source.x + quad.source.width) / pageSize;
+            const float top = quad.source.y / pageSize;
+            const float bottom = (quad.source.y + quad.source.height) / pageSize;
+
+            const float x = quad.destination.x;
+            const float y = quad.destination.y;
+            const float width = quad.destination.width;
+            const float height = quad.destination.height;
+
+            rlColor4ub(quad.tint.r, quad.tint.g, quad.tint.b, quad.tint.a);
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+
+            rlTexCoord2f(left, top);
+            rlVertex2f(x, y);
+            rlTexCoord2f(left, bottom);
+            rlVertex2f(x, y + height);
+            rlTexCoord2f(right, bottom);
+            rlVertex2f(x + width, y + height);
+            rlTexCoord2f(right, top);
+            rlVertex2f(x + width, y);
+        }
+
+        rlEnd();
+        rlSetTexture(0);
+
+        quads.clear();
+    }
+}
+
+
+GridRenderCache::GridRenderCache(const GridLayout& layout)
+{
+    SetLayout(layout);
+
+    // Never grows past this, so pointers to resident chunks stay valid.
+    m_residentChunks.reserve(maxResidentChunks);
+}
+
+GridRenderCache::~GridRenderCache()
+{
+    UnloadChunks();
+}
+
+void GridRenderCache::SetLayout(const GridLayout& layout)
+{
+    m_gridDimensions = layout.GetDimensions();
+    m_pitch = layout.GetPitch();
+
+    m_chunkDimensions = {
+        std::clamp(maxChunkPixels / std::max(m_pitch.x, 1), 1, m_gridDimensions.x),
+        std::clamp(maxChunkPixels / std::max(m_pitch.y, 1), 1, m_gridDimensions.y)
+    };
+    m_numberOfChunks = {
+        (m_gridDimensions.x + m_chunkDimensions.x - 1) / m_chunkDimensions.x,
+        (m_gridDimensions.y + m_chunkDimensions.y - 1) / m_chunkDimensions.y
+    };
+}
+
+void GridRenderCache::UnloadChunks()
+{
+    for (const Chunk& chunk : m_residentChunks) UnloadRenderTexture(chunk.texture);
+    m_residentChunks.clear();
+}
+
+void GridRenderCache::Reset(const GridLayout& layout)
+    // Follows the layout to a new game. A grid of the same size and pitch keeps its chunk
+    // textures, which are simply redrawn; otherwise they no longer fit and are unloaded.
+{
+    if (layout.GetDimensions() == m_gridDimensions && layout.GetPitch() == m_pitch)
+    {
+        MarkAllDirty();
+        return;
+    }
+
+    UnloadChunks();
+    SetLayout(layout);
+}
+
+int GridRenderCache::GetChunkIndex(const IntVector2 coords) const
+{
+    return coords.y / m_chunkDimensions.y * m_numberOfChunks.x + coords.x / m_chunkDimensions.x;
+}
+
+void GridRenderCache::GetChunkCells(const int chunkIndex, IntVector2& first, IntVector2& last) const
+{
+    first = {
+        chunkIndex % m_numberOfChunks.x * m_chunkDimensions.x,
+        chunkIndex / m_numberOfChunks.x * m_chunkDimensions.y
+    };
+    last = {
+        std::min(first.x + m_chunkDimensions.x, m_gridDimensions.x) - 1,
+        std::min(first.y + m_chunkDimensions.y, m_gridDimensions.y) - 1
+    };
+}
+
+void GridRenderCache::GetChunkRange(const IntVector2 first, const IntVector2 last, IntVector2& firstChunk, IntVector2& lastChunk) const
+{
+    firstChunk = { first.x / m_chunkDimensions.x, first.y / m_chunkDimensions.y };
+    lastChunk = { last.x / m_chunkDimensions.x, last.y / m_chunkDimensions.y };
+}
+
+GridRenderCache::Chunk* GridRenderCache::FindResident(const int chunkIndex)
+{
+    for (Chunk& chunk : m_residentChunks)
+    {
+        if (chunk.index == chunkIndex) return &chunk;
+    }
+
+    return nullptr;
+}
+
+GridRenderCache::Chunk* GridRenderCache::Acquire(const GridLayout& layout, const int chunkIndex)
+    // Returns the chunk's slot, giving it a texture if it has none. When all slots are taken, the
+    // one least recently on screen is recycled; slots already used this frame are never taken.
+{
+    Chunk* chunk = FindResident(chunkIndex);
+
+    if (chunk == nullptr)
+    {
+        if ((int)m_residentChunks.size() < maxResidentChunks)
+        {
+            chunk = &m_residentChunks.emplace_back();
+        }
+        else
+        {
+            for (Chunk& resident : m_residentChunks)
+            {
+                if (resident.lastUsedFrame == m_frame) continue;
+                if (chunk == nullptr || resident.lastUsedFrame < chunk->lastUsedFrame) chunk = &resident;
+            }
+
+            if (chunk == nullptr) return nullptr;
+
+            UnloadRenderTexture(chunk->texture);
+            chunk->dirtyCells.clear();
+        }
+
+        IntVector2 first, last;
+        GetChunkCells(chunkIndex, first, last);
+
+        const IntVector2 pitch = layout.GetPitch();
+
+        chunk->index = chunkIndex;
+        chunk->texture = LoadRenderTexture((last.x - first.x + 1) * pitch.x, (last.y - first.y + 1) * pitch.y);
+        chunk->isFullyDirty = true;
+    }
+
+    chunk->lastUsedFrame = m_frame;
+    return chunk;
+}
+
+void GridRenderCache::BeginChunk(const GridLayout& layout, const Chunk& chunk) const
+    // Starts drawing into the chunk in world coordinates and clears what is about to be redrawn.
+{
+    IntVector2 first, last;
+    GetChunkCells(chunk.index, first, last);
+
+    const IntVector2 origin = layout.GetCellPositionOnScreen(first);
+
+    BeginTextureMode(chunk.texture);
+    BeginMode2D(Camera2D{ { 0.0f, 0.0f }, { (float)origin.x, (float)origin.y }, 0.0f, 1.0f });
+
+    if (chunk.isFullyDirty)
+    {
+        ClearBackground(BLANK);
+        return;
+    }
+
+    // Writes transparent pixels instead of blending them, which erases the cells.
+    const IntVector2 pitch = layout.GetPitch();
+
+    rlSetBlendFactors(RL_ONE, RL_ZERO, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM);
+
+    for (const IntVector2 coords : chunk.dirtyCells)
+    {
+        const IntVector2 position = layout.GetCellPositionOnScreen(coords);
+        DrawRectangleRec(Rectangle{ (float)position.x, (float)position.y, (float)pitch.x, (float)pitch.y }, BLANK);
+    }
+
+    EndBlendMode();
+}
+
+void GridRenderCache::EndChunk(QuadBatch& batch, Chunk& chunk) const
+{
+    batch.Draw();
+
+    EndMode2D();
+    EndTextureMode();
+
+    chunk.isFullyDirty = false;
+    chunk.dirtyCells.clear();
+}
+
+void GridRenderCache::MarkDirty(const IntVector2 coords)
+    // Chunks that are not resident are redrawn in full anyway, so they need no record.
+{
+    Chunk* chunk = FindResident(GetChunkIndex(coords));
+    if (chunk == nullptr || chunk->isFullyDirty) return;
+
+    chunk->dirtyCells.push_back(coords);
+
+    // Past this point clearing the whole texture is cheaper than erasing cell by cell.
+    if ((int)chunk->dirtyCells.size() >= m_chunkDimensions.x * m_chunkDimensions.y / 4)
+    {
+        chunk->isFullyDirty = true;
+        chunk->dirtyCells.clear();
+    }
+}
+
+void GridRenderCache::MarkDirty(const int y, const int startX, const int endX)
+{
+    for (int x = startX; x <= endX; x++) MarkDirty(IntVector2{ x, y });
+}
+
+void GridRenderCache::MarkAllDirty()
+{
+    for (Chunk& chunk : m_residentChunks)
+    {
+        chunk.isFullyDirty = true;
+        chunk.dirtyCells.clear();
+    }
+}
+
+void GridRenderCache::Draw(const GridLayout& layout, const IntVector2 first, const IntVector2 last)
+    // Blits the chunks over cells [first, last]; expects to be inside the grid camera's 2D mode.
+{
+    IntVector2 firstChunk, lastChunk;
+    GetChunkRange(first, last, firstChunk, lastChunk);
+
+    for (int chunkY = firstChunk.y; chunkY <= lastChunk.y; chunkY++)
+    {
+        for (int chunkX = firstChunk.x; chunkX <= lastChunk.x; chunkX++)
+        {
+            const Chunk* chunk = FindResident(chunkY * m_numberOfChunks.x + chunkX);
+            if (chunk == nullptr) continue;
+
+            IntVector2 firstCell, lastCell;
+            GetChunkCells(chunk->index, firstCell, lastCell);
+
+            const IntVector2 origin = layout.GetCellPositionOnScreen(firstCell);
+            const Texture2D& texture = chunk->texture.texture;
+
+            // Render textures are stored upside down.
+            DrawTextureRec(texture, Rectangle{ 0, 0, (float)texture.width, -(float)texture.height }, Vector2{ (float)origin.x, (float)origin.y }, WHITE);
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#include "engine/actionlog.h"
+#include "engine/simulation.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace Minesweeper;
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::printf(
+            "Usage: minesweeper-sim [options]\n"
+            "  --size WxH[,WxH...]         Board sizes (default 9x9)\n"
+            "  --density D[,D...]          Bomb densities (default 0.15)\n"
+            "  --games N                   Games per configuration (default 1000)\n"
+            "  --policy random|solver      Player policy (default solver)\n"
+            "  --first-click unsafe|safe|opening   (default safe)\n"
+            "  --no-guess                  Only play boards the solver can clear\n"
+            "  --seed S                    Base seed (default 0)\n"
+            "  --threads N                 Worker threads, 0 for all cores (default 0)\n"
+            "  --corpus FILE               Continue the games saved in a snapshot corpus instead of\n"
+            "                              generating boards (--size, --density, --first-click and\n"
+            "                              --no-guess are then ignored)\n"
+            "  --save-corpus FILE          Save every game's position after its first click\n"
+            "  --replay FILE[,FILE...]     Replay recorded action logs as fast as possible and report\n"
+            "                              how each game ended, instead of simulating\n");
+    }
+
+    std::vector<std::string> Split(const std::string& text, const char separator)
+    {
+        std::vector<std::string> parts;
+        std::stringstream stream(text);
+        std::string part;
+
+        while (std::getline(stream, part, separator)) parts.push_back(part);
+        return parts;
+    }
+
+    IntVector2 ParseSize(const std::string& text)
+    {
+        const std::vector<std::string> parts = Split(text, 'x');
+        if (parts.size() != 2) throw std::invalid_argument("Size must look like WxH: " + text);
+
+        return IntVector2{ std::stoi(parts[0]), std::stoi(parts[1]) };
+    }
+
+    PolicyType ParsePolicy(const std::string& text)
+    {
+        if (text == "random") return PolicyType::RANDOM;
+        if (text == "solver") return PolicyType::SOLVER;
+        throw std::invalid_argument("Unknown policy: " + text);
+    }
+
+    FirstClickPolicy ParseFirstClickPolicy(const std::string& text)
+    {
+        if (text == "unsafe") return FirstClickPolicy::UNSAFE;
+        if (text == "safe") return FirstClickPolicy::SAFE;
+        if (text == "opening") return FirstClickPolicy::OPENING;
+        throw std::invalid_argument("Unknown first click policy: " + text);
+    }
+
+    int ReplayLogs(const std::vector<std::string>& filePaths)
+        // A log whose replay diverges from what was recorded (an action that no longer changes
+        // anything) is reported with the first such action, and makes the run fail.
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::printf("%-32s %10s %-10s %10s %12s\n", "log", "actions", "outcome", "mismatch", "actions/s");
+
+        Board board(IntVector2{ 1, 1 }, 0);
+        int numberOfMismatches = 0;
+
+        for (const std::string& filePath : filePaths)
+        {
+            const ActionLogReader log(filePath);
+
+            const Clock::time_point start = Clock::now();
+            const ReplayResult result = Replay(log, board);
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            const char* outcome = result.isBombTriggered ? "lost" : (result.isCleared ? "won" : "unfinished");
+            numberOfMismatches += result.firstMismatch >= 0;
+
+            std::printf("%-32s %10zu %-10s %10lld %12.0f\n",
+                filePath.c_str(),
+                result.numberOfActions,
+                outcome,
+                (long long)result.firstMismatch,
+                seconds > 0.0 ? result.numberOfActions / seconds : 0.0);
+        }
+
+        return numberOfMismatches > 0 ? 2 : 0;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    SimulationConfig config;
+    std::vector<IntVector2> sizes = { config.dimensions };
+    std::vector<float> densities = { config.bombDensity };
+    std::string policyName = "solver";
+    std::string corpusFilePath;
+    std::string savedCorpusFilePath;
+    std::vector<std::string> replayFilePaths;
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string option = argv[i];
+
+            if (option == "--help" || option == "-h")
+            {
+                PrintUsage();
+                return 0;
+            }
+
+            if (option == "--no-guess")
+            {
+                config.generationOptions.isNoGuess = true;
+                continue;
+            }
+
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + option);
+            const std::string value = argv[++i];
+
+            if (option == "--size")
+            {
+                sizes.clear();
+                for (const std::string& size : Split(value, ',')) sizes.push_back(ParseSize(size));
+            }
+            else if (option == "--density")
+            {
+                densities.clear();
+                for (const std::string& density : Split(value, ',')) densities.push_back(std::stof(density));
+            }
+            else if (option == "--games") config.numberOfGames = std::stoi(value);
+            else if (option == "--policy")
+            {
+                config.policy = ParsePolicy(value);
+                policyName = value;
+            }
+            else if (option == "--first-click") config.generationOptions.firstClickPolicy = ParseFirstClickPolicy(value);
+            else if (option == "--seed") config.seed = std::stoull(value);
+            else if (option == "--threads") config.numberOfThreads = std::stoi(value);
+            else if (option == "--corpus") corpusFilePath = value;
+            else if (option == "--save-corpus") savedCorpusFilePath = value;
+            else if (option == "--replay") replayFilePaths = Split(value, ',');
+            else throw std::invalid_argument("Unknown option: " + option);
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::fprintf(stderr, "%s\n", error.what());
+        PrintUsage();
+        return 1;
+    }
+
+    if (!replayFilePaths.empty())
+    {
+        try
+        {
+            return ReplayLogs(replayFilePaths);
+        }
+        catch (const std::exception& error)
+        {
+            std::fprintf(stderr, "%s\n", error.what());
+            return 1;
+        }
+    }
+
+    std::printf("%-11s %8s %-7s %8s %9s %12s %12s %10s\n", "size", "density", "policy", "games", "win rate", "mean clicks", "ms/game", "games/s");
+
+    try
+    {
+        std::unique_ptr<SnapshotCorpus> corpus;
+        std::vector<std::byte> savedCorpus;
+
+        if (!corpusFilePath.empty())
+        {
+            // The boards come from the corpus, so there is a single configuration to run.
+            corpus = std::make_unique<SnapshotCorpus>(corpusFilePath);
+            config.corpus = corpus.get();
+            sizes.resize(1);
+            densities.resize(1);
+        }
+
+        config.isCorpusRecorded = !savedCorpusFilePath.empty();
+
+        for (const IntVector2 size : sizes)
+        {
+            for (const float density : densities)
+            {
+                config.dimensions = size;
+                config.bombDensity = density;
+
+                const SimulationResult result = RunSimulation(config);
+                savedCorpus.insert(savedCorpus.end(), result.corpus.begin(), result.corpus.end());
+
+                char densityText[16] = "-";
+                if (corpus == nullptr) std::snprintf(densityText, sizeof(densityText), "%.3f", density);
+
+                std::printf("%-11s %8s %-7s %8d %8.2f%% %12.2f %12.4f %10.1f\n",
+                    corpus != nullptr ? "corpus" : (std::to_string(size.x) + "x" + std::to_string(size.y)).c_str(),
+                    densityText,
+                    policyName.c_str(),
+                    result.numberOfGames,
+                    result.GetWinRate() * 100.0,
+                    result.GetMeanClicks(),
+                    result.GetMeanGameMilliseconds(),
+                    result.GetGamesPerSecond());
+            }
+        }
+
+        if (config.isCorpusRecorded)
+        {
+            // Snapshots are self-delimiting, so the corpora of all configurations go in one file.
+            std::FILE* file = std::fopen(savedCorpusFilePath.c_str(), "wb");
+            if (file == nullptr) throw std::runtime_error("Cannot write " + savedCorpusFilePath);
+
+            const bool isWritten = std::fwrite(savedCorpus.data(), 1, savedCorpus.size(), file) == savedCorpus.size();
+            if (std::fclose(file) != 0 || !isWritten) throw std::runtime_error("Cannot write " + savedCorpusFilePath);
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+
+    return 0;
+}